@@ -0,0 +1,510 @@
+#include "VulkanCommon.hpp"
+#include "FrameEngine.hpp"
+#include "PipelineCacheStore.hpp"
+#include "UploadManager.hpp"
+#include "GpuAllocator.hpp"
+#include "GpuProfiler.hpp"
+#include "ShaderCache.hpp"
+#include "DescriptorAllocator.hpp"
+#include "BindlessTextures.hpp"
+#include "DepthPyramid.hpp"
+#include "GpuScene.hpp"
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+Headless benchmark harness: runs scripted workloads against the same engine
+modules the app uses and emits machine-readable results, so driver updates get
+validated by numbers instead of eyeballing. Scenarios sweep the axes that
+actually move frame time - draw count (GPU-driven cull + command build),
+resolution (clear + HiZ pyramid cost) and bindless texture residency
+(update-after-bind descriptor churn).
+
+Each scenario renders a fixed number of frames into offscreen targets and
+reports CPU avg/p99 and the GPU "frame" scope average. Results go to a JSON
+file; when a baseline file exists, any scenario slower than baseline by more
+than the threshold fails the run with a non-zero exit code, which is what the
+fleet CI gates on.
+
+    vulkan_bench [--frames N] [--baseline file] [--output file] [--threshold pct]
+*/
+
+namespace {
+
+struct Scenario {
+    std::string name;
+    uint32_t objectCount = 0;
+    vk::Extent2D extent{ 1280, 720 };
+    uint32_t residentTextures = 0;
+};
+
+struct ScenarioResult {
+    std::string name;
+    double cpuAvgMs = 0.0;
+    double cpuP99Ms = 0.0;
+    double gpuAvgMs = 0.0;
+};
+
+class BenchHarness {
+public:
+
+    void init() {
+
+        constexpr vk::ApplicationInfo appInfo{ .pApplicationName = "Vulkan Bench",
+                                               .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
+                                               .pEngineName = "No Engine",
+                                               .engineVersion = VK_MAKE_VERSION(1, 0, 0),
+                                               .apiVersion = vk::HeaderVersionComplete };
+        _instance = vk::raii::Instance(_context, vk::InstanceCreateInfo{ .pApplicationInfo = &appInfo });
+
+        pickPhysicalDevice();
+        createDevice();
+
+        _pipelineCacheStore.init(_device, _physicalDevice, "pipeline_cache.bin");
+        _gpuAllocator.init(_device, _physicalDevice);
+        _shaderCache.init(_device);
+        _uploadManager.init(_device, _physicalDevice, _transferQueueIndex, _graphicsQueueIndex);
+        _descriptorAllocator.init(_device, FrameEngine::MaxFramesInFlight);
+        _bindlessTextures.init(_device, _descriptorIndexingSupported);
+        _depthPyramid.init(_device, _physicalDevice, _gpuAllocator, _shaderCache, _pipelineCacheStore);
+        _gpuScene.init(_device, _gpuAllocator, _shaderCache, _pipelineCacheStore,
+                       _drawIndirectCountSupported, _multiDrawIndirectSupported);
+        _frameEngine.init(_device, _graphicsQueueIndex);
+        _gpuProfiler.init(_device, _physicalDevice, _graphicsQueueIndex, FrameEngine::MaxFramesInFlight);
+    }
+
+    std::string deviceName() const {
+        return std::string(_physicalDevice.getProperties().deviceName.data());
+    }
+
+    ScenarioResult run(const Scenario& scenario, uint32_t frames) {
+
+        prepare(scenario);
+
+        std::vector<double> cpuTimesMs;
+        cpuTimesMs.reserve(frames);
+        double gpuTotalMs = 0.0;
+        uint32_t gpuSamples = 0;
+
+        for (uint32_t frame = 0; frame < frames; frame++)
+        {
+            const auto frameStart = std::chrono::steady_clock::now();
+            renderFrame(scenario);
+            cpuTimesMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+
+            for (const GpuProfiler::Timing& timing : _gpuProfiler.latestTimings())
+            {
+                if (timing.name == "frame")
+                {
+                    gpuTotalMs += timing.milliseconds;
+                    gpuSamples++;
+                }
+            }
+        }
+        _frameEngine.waitForSubmitted(_device);
+
+        std::ranges::sort(cpuTimesMs);
+        double sum = 0.0;
+        for (const double ms : cpuTimesMs)
+            sum += ms;
+
+        ScenarioResult result;
+        result.name = scenario.name;
+        result.cpuAvgMs = sum / static_cast<double>(cpuTimesMs.size());
+        result.cpuP99Ms = cpuTimesMs[std::min(cpuTimesMs.size() - 1, static_cast<size_t>(0.99 * static_cast<double>(cpuTimesMs.size())))];
+        result.gpuAvgMs = (gpuSamples > 0) ? gpuTotalMs / gpuSamples : 0.0;
+        return result;
+    }
+
+    void shutdown() {
+        _frameEngine.waitForSubmitted(_device);
+        _shaderCache.shutdown();
+        _pipelineCacheStore.save();
+    }
+
+private:
+
+    struct ColorTarget {
+        vk::raii::Image image = nullptr;
+        GpuAllocator::Allocation allocation;
+    };
+
+    struct ResidentTexture {
+        vk::raii::Image image = nullptr;
+        GpuAllocator::Allocation allocation;
+        vk::raii::ImageView view = nullptr;
+        uint32_t slot = 0;
+    };
+
+    void pickPhysicalDevice() {
+
+        //Deterministic choice over clever scoring: benches must hit the same GPU every run
+        for (const auto& device : _instance.enumeratePhysicalDevices())
+        {
+            if (device.getProperties().apiVersion < VK_API_VERSION_1_4)
+                continue;
+            const auto queueFamilies = device.getQueueFamilyProperties();
+            const bool hasGraphics = std::ranges::any_of(queueFamilies, [](const auto& qfp) {
+                return (qfp.queueFlags & vk::QueueFlagBits::eGraphics) != static_cast<vk::QueueFlags>(0); });
+            if (hasGraphics)
+            {
+                _physicalDevice = device;
+                return;
+            }
+        }
+        throw std::runtime_error("no Vulkan 1.4 GPU with a graphics queue found");
+    }
+
+    void createDevice() {
+
+        const auto queueFamilies = _physicalDevice.getQueueFamilyProperties();
+        for (uint32_t index = 0; index < queueFamilies.size(); index++)
+        {
+            const auto flags = queueFamilies[index].queueFlags;
+            if (_graphicsQueueIndex == UINT32_MAX && (flags & vk::QueueFlagBits::eGraphics) != static_cast<vk::QueueFlags>(0))
+                _graphicsQueueIndex = index;
+            const bool transferOnly = (flags & vk::QueueFlagBits::eTransfer) != static_cast<vk::QueueFlags>(0) &&
+                                      (flags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute)) == static_cast<vk::QueueFlags>(0);
+            if (transferOnly && _transferQueueIndex == UINT32_MAX)
+                _transferQueueIndex = index;
+        }
+        if (_transferQueueIndex == UINT32_MAX)
+            _transferQueueIndex = _graphicsQueueIndex;
+
+        const auto supportedFeatures = _physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        const auto& supported12 = supportedFeatures.get<vk::PhysicalDeviceVulkan12Features>();
+        _drawIndirectCountSupported = static_cast<bool>(supported12.drawIndirectCount);
+        _descriptorIndexingSupported = supported12.runtimeDescriptorArray &&
+                                       supported12.shaderSampledImageArrayNonUniformIndexing &&
+                                       supported12.descriptorBindingPartiallyBound &&
+                                       supported12.descriptorBindingSampledImageUpdateAfterBind &&
+                                       supported12.descriptorBindingVariableDescriptorCount;
+        _multiDrawIndirectSupported =
+            static_cast<bool>(supportedFeatures.get<vk::PhysicalDeviceFeatures2>().features.multiDrawIndirect);
+
+        vk::StructureChain<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features, vk::PhysicalDeviceVulkan13Features> featureChain = {
+            {.features = {.multiDrawIndirect = _multiDrawIndirectSupported } },
+            {.drawIndirectCount = _drawIndirectCountSupported,
+             .shaderSampledImageArrayNonUniformIndexing = _descriptorIndexingSupported,
+             .descriptorBindingSampledImageUpdateAfterBind = _descriptorIndexingSupported,
+             .descriptorBindingPartiallyBound = _descriptorIndexingSupported,
+             .descriptorBindingVariableDescriptorCount = _descriptorIndexingSupported,
+             .runtimeDescriptorArray = _descriptorIndexingSupported },
+            {.synchronization2 = true, .dynamicRendering = true }
+        };
+
+        float queuePriority = 0.0f;
+        std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
+        queueCreateInfos.push_back({ .queueFamilyIndex = _graphicsQueueIndex, .queueCount = 1, .pQueuePriorities = &queuePriority });
+        if (_transferQueueIndex != _graphicsQueueIndex)
+            queueCreateInfos.push_back({ .queueFamilyIndex = _transferQueueIndex, .queueCount = 1, .pQueuePriorities = &queuePriority });
+
+        _device = vk::raii::Device(_physicalDevice, vk::DeviceCreateInfo{
+            .pNext = &featureChain.get<vk::PhysicalDeviceFeatures2>(),
+            .queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size()),
+            .pQueueCreateInfos = queueCreateInfos.data() });
+        _graphicsQueue = vk::raii::Queue(_device, _graphicsQueueIndex, 0);
+    }
+
+    void prepare(const Scenario& scenario) {
+
+        _frameEngine.waitForSubmitted(_device);
+
+        if (scenario.extent != _currentExtent)
+        {
+            //Destroy the old images first, then hand their ranges back to the pool
+            for (ColorTarget& target : _colorTargets)
+            {
+                target.image = nullptr;
+                _gpuAllocator.free(target.allocation);
+            }
+            _colorTargets.clear();
+            for (uint32_t i = 0; i < FrameEngine::MaxFramesInFlight; i++)
+            {
+                ColorTarget target;
+                target.image = vk::raii::Image(_device, vk::ImageCreateInfo{
+                    .imageType = vk::ImageType::e2D,
+                    .format = vk::Format::eB8G8R8A8Srgb,
+                    .extent = { .width = scenario.extent.width, .height = scenario.extent.height, .depth = 1 },
+                    .mipLevels = 1,
+                    .arrayLayers = 1,
+                    .samples = vk::SampleCountFlagBits::e1,
+                    .tiling = vk::ImageTiling::eOptimal,
+                    .usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferDst,
+                    .sharingMode = vk::SharingMode::eExclusive,
+                    .initialLayout = vk::ImageLayout::eUndefined });
+                target.allocation = _gpuAllocator.allocate(target.image.getMemoryRequirements(), vk::MemoryPropertyFlagBits::eDeviceLocal);
+                target.image.bindMemory(target.allocation.memory, target.allocation.offset);
+                _colorTargets.push_back(std::move(target));
+            }
+            _depthPyramid.create(scenario.extent);
+            _currentExtent = scenario.extent;
+        }
+
+        if (scenario.objectCount != _gpuScene.objectCount())
+        {
+            std::vector<GpuScene::Object> objects(scenario.objectCount);
+            for (uint32_t i = 0; i < scenario.objectCount; i++)
+            {
+                GpuScene::Object& object = objects[i];
+                for (int d = 0; d < 4; d++)
+                    object.transform[d * 4 + d] = 1.0f;
+                //Deterministic grid so every run culls the same scene
+                object.center[0] = static_cast<float>(i % 100) - 50.0f;
+                object.center[1] = static_cast<float>((i / 100) % 100) - 50.0f;
+                object.center[2] = static_cast<float>(i / 10000) + 1.0f;
+                object.extents[0] = object.extents[1] = object.extents[2] = 0.5f;
+                object.indexCount = 36;
+                object.materialBucket = i % 8;
+            }
+            _gpuScene.setObjects(objects, _uploadManager);
+        }
+
+        setResidentTextures(scenario.residentTextures);
+    }
+
+    void setResidentTextures(uint32_t count) {
+
+        if (!_bindlessTextures.supported())
+            return;
+
+        for (ResidentTexture& texture : _residentTextures)
+        {
+            _bindlessTextures.remove(texture.slot);
+            texture.view = nullptr;
+            texture.image = nullptr;
+            _gpuAllocator.free(texture.allocation);
+        }
+        _residentTextures.clear();
+
+        if (count == 0)
+            return;
+
+        if (_residentSampler == nullptr)
+            _residentSampler = vk::raii::Sampler(_device, vk::SamplerCreateInfo{});
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            ResidentTexture texture;
+            texture.image = vk::raii::Image(_device, vk::ImageCreateInfo{
+                .imageType = vk::ImageType::e2D,
+                .format = vk::Format::eR8G8B8A8Unorm,
+                .extent = { .width = 4, .height = 4, .depth = 1 },
+                .mipLevels = 1,
+                .arrayLayers = 1,
+                .samples = vk::SampleCountFlagBits::e1,
+                .tiling = vk::ImageTiling::eOptimal,
+                .usage = vk::ImageUsageFlagBits::eSampled,
+                .sharingMode = vk::SharingMode::eExclusive,
+                .initialLayout = vk::ImageLayout::eUndefined });
+            texture.allocation = _gpuAllocator.allocate(texture.image.getMemoryRequirements(), vk::MemoryPropertyFlagBits::eDeviceLocal);
+            texture.image.bindMemory(texture.allocation.memory, texture.allocation.offset);
+            texture.view = vk::raii::ImageView(_device, vk::ImageViewCreateInfo{
+                .image = texture.image,
+                .viewType = vk::ImageViewType::e2D,
+                .format = vk::Format::eR8G8B8A8Unorm,
+                .subresourceRange = { .aspectMask = vk::ImageAspectFlagBits::eColor,
+                                      .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 } });
+            texture.slot = _bindlessTextures.add(texture.view, _residentSampler);
+            _residentTextures.push_back(std::move(texture));
+        }
+    }
+
+    void renderFrame(const Scenario& scenario) {
+
+        FrameEngine::Frame& frame = _frameEngine.beginFrame(_device);
+        _descriptorAllocator.beginFrame(_frameEngine.currentFrameSlot());
+        _gpuProfiler.beginFrame(_frameEngine.currentFrameSlot(), frame.commandBuffer);
+        const uint32_t frameScope = _gpuProfiler.beginScope(frame.commandBuffer, "frame");
+
+        //Complete the queue-ownership handoff for anything the transfer queue released
+        //since the last frame, before the cull compute reads the scene buffers
+        _uploadManager.recordGraphicsAcquire(frame.commandBuffer);
+
+        /*Steady-state residency churn: rewrite a slice of slots per frame, the way a
+          streaming world swaps textures in and out of the table.*/
+        if (_bindlessTextures.supported() && !_residentTextures.empty())
+        {
+            const uint32_t churn = std::min<uint32_t>(16, static_cast<uint32_t>(_residentTextures.size()));
+            for (uint32_t i = 0; i < churn; i++)
+            {
+                ResidentTexture& texture = _residentTextures[(_churnCursor + i) % _residentTextures.size()];
+                _bindlessTextures.remove(texture.slot);
+                texture.slot = _bindlessTextures.add(texture.view, _residentSampler);
+            }
+            _churnCursor += churn;
+        }
+
+        const vk::Image colorImage = _colorTargets[_frameEngine.currentFrameSlot()].image;
+        const vk::ImageSubresourceRange colorRange{ .aspectMask = vk::ImageAspectFlagBits::eColor,
+                                                    .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 };
+        vk::ImageMemoryBarrier2 toClear{
+            .srcStageMask = vk::PipelineStageFlagBits2::eTopOfPipe,
+            .dstStageMask = vk::PipelineStageFlagBits2::eClear,
+            .dstAccessMask = vk::AccessFlagBits2::eTransferWrite,
+            .oldLayout = vk::ImageLayout::eUndefined,
+            .newLayout = vk::ImageLayout::eTransferDstOptimal,
+            .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+            .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+            .image = colorImage,
+            .subresourceRange = colorRange };
+        frame.commandBuffer.pipelineBarrier2(vk::DependencyInfo{ .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &toClear });
+        frame.commandBuffer.clearColorImage(colorImage, vk::ImageLayout::eTransferDstOptimal,
+                                            vk::ClearColorValue(0.0f, 0.0f, 0.0f, 1.0f), colorRange);
+
+        _depthPyramid.recordClear(frame.commandBuffer);
+        _depthPyramid.recordDownsample(frame.commandBuffer, _descriptorAllocator, vk::ImageLayout::eTransferDstOptimal);
+
+        if (_gpuScene.objectCount() > 0)
+        {
+            DepthPyramid::CullParams cullParams;
+            for (int d = 0; d < 4; d++)
+                cullParams.viewProj[d * 4 + d] = 1.0f;
+            cullParams.objectCount = _gpuScene.objectCount();
+            _depthPyramid.recordCull(frame.commandBuffer, _descriptorAllocator,
+                                     _gpuScene.boundsBuffer(), _gpuScene.visibilityBuffer(), cullParams);
+            _gpuScene.recordBuildDraws(frame.commandBuffer, _descriptorAllocator);
+        }
+
+        _gpuProfiler.endScope(frame.commandBuffer, frameScope);
+        _frameEngine.submitFrame(_graphicsQueue);
+    }
+
+    vk::raii::Context _context;
+    vk::raii::Instance _instance = nullptr;
+    vk::raii::PhysicalDevice _physicalDevice = nullptr;
+    vk::raii::Device _device = nullptr;
+    vk::raii::Queue _graphicsQueue = nullptr;
+    uint32_t _graphicsQueueIndex = UINT32_MAX;
+    uint32_t _transferQueueIndex = UINT32_MAX;
+    bool _drawIndirectCountSupported = false;
+    bool _multiDrawIndirectSupported = false;
+    bool _descriptorIndexingSupported = false;
+
+    PipelineCacheStore _pipelineCacheStore;
+    GpuAllocator _gpuAllocator;
+    ShaderCache _shaderCache;
+    UploadManager _uploadManager;
+    DescriptorAllocator _descriptorAllocator;
+    BindlessTextures _bindlessTextures;
+    DepthPyramid _depthPyramid;
+    GpuScene _gpuScene;
+    FrameEngine _frameEngine;
+    GpuProfiler _gpuProfiler;
+
+    std::vector<ColorTarget> _colorTargets;
+    vk::Extent2D _currentExtent{ 0, 0 };
+    std::vector<ResidentTexture> _residentTextures;
+    vk::raii::Sampler _residentSampler = nullptr;
+    uint32_t _churnCursor = 0;
+};
+
+std::vector<Scenario> defaultScenarios() {
+    return {
+        //Draw-count sweep: cull + command-build cost as the scene grows
+        { .name = "draws_0",    .objectCount = 0 },
+        { .name = "draws_1k",   .objectCount = 1'000 },
+        { .name = "draws_10k",  .objectCount = 10'000 },
+        { .name = "draws_100k", .objectCount = 100'000 },
+        //Resolution sweep: clear + pyramid rebuild cost per pixel
+        { .name = "res_1080p", .objectCount = 10'000, .extent = { 1920, 1080 } },
+        { .name = "res_4k",    .objectCount = 10'000, .extent = { 3840, 2160 } },
+        //Residency sweep: update-after-bind churn against the bindless table
+        { .name = "residency_512",  .objectCount = 10'000, .extent = { 1920, 1080 }, .residentTextures = 512 },
+        { .name = "residency_2048", .objectCount = 10'000, .extent = { 1920, 1080 }, .residentTextures = 2048 },
+    };
+}
+
+} //namespace
+
+int main(int argc, char* argv[]) {
+
+    uint32_t frames = 240;
+    std::string baselineFile = "bench_baseline.json";
+    std::string outputFile = "bench_results.json";
+    double thresholdPercent = 10.0;
+
+    for (int arg = 1; arg + 1 < argc; arg += 2)
+    {
+        if (std::strcmp(argv[arg], "--frames") == 0)
+            frames = static_cast<uint32_t>(std::stoul(argv[arg + 1]));
+        else if (std::strcmp(argv[arg], "--baseline") == 0)
+            baselineFile = argv[arg + 1];
+        else if (std::strcmp(argv[arg], "--output") == 0)
+            outputFile = argv[arg + 1];
+        else if (std::strcmp(argv[arg], "--threshold") == 0)
+            thresholdPercent = std::stod(argv[arg + 1]);
+    }
+
+    try
+    {
+        BenchHarness harness;
+        harness.init();
+
+        nlohmann::json results;
+        results["device"] = harness.deviceName();
+        results["frames"] = frames;
+        results["scenarios"] = nlohmann::json::array();
+
+        std::vector<ScenarioResult> measured;
+        for (const Scenario& scenario : defaultScenarios())
+        {
+            const ScenarioResult result = harness.run(scenario, frames);
+            measured.push_back(result);
+            results["scenarios"].push_back({ { "name", result.name },
+                                             { "cpuAvgMs", result.cpuAvgMs },
+                                             { "cpuP99Ms", result.cpuP99Ms },
+                                             { "gpuAvgMs", result.gpuAvgMs } });
+            std::cout << result.name << ": cpu " << result.cpuAvgMs << " ms (p99 " << result.cpuP99Ms
+                      << "), gpu " << result.gpuAvgMs << " ms" << std::endl;
+        }
+        harness.shutdown();
+
+        std::ofstream output(outputFile, std::ios::trunc);
+        output << results.dump(2) << std::endl;
+
+        //Regression gate: compare against the baseline when one exists
+        std::ifstream baseline(baselineFile);
+        if (!baseline)
+        {
+            std::cout << "No baseline at " << baselineFile << " - results written, nothing gated" << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        const nlohmann::json baselineJson = nlohmann::json::parse(baseline);
+        bool regressed = false;
+        for (const ScenarioResult& result : measured)
+        {
+            for (const auto& baselineScenario : baselineJson.value("scenarios", nlohmann::json::array()))
+            {
+                if (baselineScenario.value("name", std::string{}) != result.name)
+                    continue;
+
+                const auto check = [&](const char* metric, double current, double reference) {
+                    if (reference > 0.0 && current > reference * (1.0 + thresholdPercent / 100.0))
+                    {
+                        std::cerr << "REGRESSION " << result.name << " " << metric << ": "
+                                  << current << " ms vs baseline " << reference << " ms" << std::endl;
+                        regressed = true;
+                    }
+                };
+                check("cpuAvgMs", result.cpuAvgMs, baselineScenario.value("cpuAvgMs", 0.0));
+                check("gpuAvgMs", result.gpuAvgMs, baselineScenario.value("gpuAvgMs", 0.0));
+            }
+        }
+        return regressed ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
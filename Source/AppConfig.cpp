@@ -0,0 +1,36 @@
+#include "AppConfig.hpp"
+
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <iostream>
+
+AppConfig AppConfig::load(const std::filesystem::path& configFile) {
+
+    AppConfig config;
+
+    std::ifstream file(configFile);
+    if (!file)
+        return config; //no file is fine, run with defaults
+
+    try
+    {
+        const nlohmann::json json = nlohmann::json::parse(file);
+        const auto window = json.value("window", nlohmann::json::object());
+        config.windowWidth = window.value("width", config.windowWidth);
+        config.windowHeight = window.value("height", config.windowHeight);
+        config.windowCount = window.value("count", config.windowCount);
+        config.presentModePolicy = json.value("presentModePolicy", config.presentModePolicy);
+        config.targetFps = json.value("targetFps", config.targetFps);
+        config.validationMode = json.value("validationMode", config.validationMode);
+        config.headless = json.value("headless", config.headless);
+        config.hitchThresholdMs = json.value("hitchThresholdMs", config.hitchThresholdMs);
+    }
+    catch (const nlohmann::json::exception& e)
+    {
+        //A malformed config should not brick a deployed unit - complain and use defaults
+        std::cerr << "Failed to parse " << configFile << ": " << e.what() << std::endl;
+        return AppConfig{};
+    }
+
+    return config;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+/*
+Runtime configuration loaded from a JSON file next to the executable. Every field
+has a sane default so a missing or partial file never stops the app - deployments
+only write the keys they want to override.
+
+presentModePolicy picks the vsync strategy per deployment:
+  "lowLatency" - IMMEDIATE if available (esports: tearing is fine, every ms counts)
+  "powerSave"  - plain FIFO (signage: halves GPU power draw versus mailbox)
+  "adaptive"   - FIFO_RELAXED (vsync normally, tear instead of stutter when late)
+  "smooth"     - MAILBOX if available, the previous hardcoded behaviour (default)
+*/
+struct AppConfig {
+
+    int windowWidth = 800;
+    int windowHeight = 600;
+    //Video-wall deployments drive one window per display from a single device; each
+    //window gets its own surface and swapchain but everything else is shared
+    int windowCount = 1;
+    std::string presentModePolicy = "smooth";
+    double targetFps = 60.0; //0 = uncapped (present mode still throttles unless immediate)
+
+    /*Validation is a runtime decision, not a build-type one:
+        "off"    - no layer, no messenger
+        "errors" - debug messenger at Error severity only, WITHOUT the validation layer;
+                   captures driver errors from deployed units at zero validation cost
+        "full"   - VK_LAYER_KHRONOS_validation plus a verbose messenger (30-40% slower)
+      Empty means pick by build type (full in debug, errors in release). The
+      VULKAN_TUTORIAL_VALIDATION environment variable overrides the config.*/
+    std::string validationMode;
+
+    /*Headless mode: no SDL window, surface or swapchain - rendering goes to offscreen
+      images and "present" is a copy into host-visible readback buffers. For CI
+      image-diff farms and server-side renderers on display-less GPU nodes. The
+      VULKAN_TUTORIAL_HEADLESS environment variable (any non-empty value) also
+      enables it.*/
+    bool headless = false;
+
+    //Frames slower than this get a hitch record (with profiler snapshot) in the telemetry stream
+    double hitchThresholdMs = 33.0;
+
+    static AppConfig load(const std::filesystem::path& configFile);
+};
@@ -0,0 +1,112 @@
+#include "AssetStreamer.hpp"
+
+#include "PackFile.hpp"
+#include "UploadManager.hpp"
+#include "FrameArena.hpp"
+
+void AssetStreamer::init(const PackFile& pack) {
+    _pack = &pack;
+    _worker = std::jthread([this] { workerLoop(); });
+}
+
+AssetStreamer::Ticket AssetStreamer::queueBuffer(std::string_view name, vk::Buffer dstBuffer, vk::DeviceSize dstOffset) {
+
+    const PackFile::Entry* entry = _pack->find(name);
+    if (entry == nullptr)
+        return 0;
+
+    Request request;
+    request.data = _pack->data(*entry);
+    request.size = entry->size;
+    request.dstBuffer = dstBuffer;
+    request.dstOffset = dstOffset;
+
+    {
+        std::lock_guard lock(_mutex);
+        request.ticket = _nextTicket++;
+        _pending.push_back(request);
+    }
+    _workAvailable.notify_one();
+    return request.ticket;
+}
+
+void AssetStreamer::workerLoop() {
+
+    while (true)
+    {
+        Request request;
+        {
+            std::unique_lock lock(_mutex);
+            _workAvailable.wait(lock, [this] { return _stopping || !_pending.empty(); });
+            if (_stopping)
+                return;
+            request = _pending.front();
+            _pending.pop_front();
+        }
+
+        /*Touch one byte per page so the disk reads happen here. pump()'s memcpy
+          into the staging buffer then hits warm pages instead of faulting on the
+          frame thread.*/
+        constexpr size_t pageSize = 4096;
+        volatile std::byte sink{};
+        for (size_t offset = 0; offset < request.size; offset += pageSize)
+            sink = request.data[offset];
+        if (request.size > 0)
+            sink = request.data[request.size - 1];
+        (void)sink;
+
+        {
+            std::lock_guard lock(_mutex);
+            _prefetched.push_back(request);
+        }
+    }
+}
+
+void AssetStreamer::pump(UploadManager& uploads, FrameArena& arena, vk::DeviceSize maxBytesPerFrame) {
+
+    FrameVector<Request> batch{ FrameAllocator<Request>(arena) };
+    {
+        std::lock_guard lock(_mutex);
+        vk::DeviceSize budget = maxBytesPerFrame;
+        while (!_prefetched.empty())
+        {
+            const Request& next = _prefetched.front();
+            //Always let at least one request through, or an oversized asset would stall forever
+            if (!batch.empty() && next.size > budget)
+                break;
+            budget -= std::min(budget, next.size);
+            batch.push_back(next);
+            _prefetched.pop_front();
+        }
+    }
+
+    if (batch.empty())
+        return;
+
+    for (const Request& request : batch)
+        uploads.stage(request.data, request.size, request.dstBuffer, request.dstOffset);
+    uploads.flush();
+
+    {
+        std::lock_guard lock(_mutex);
+        for (const Request& request : batch)
+            _staged.insert(request.ticket);
+    }
+}
+
+bool AssetStreamer::isStaged(Ticket ticket) const {
+    std::lock_guard lock(_mutex);
+    return _staged.contains(ticket);
+}
+
+void AssetStreamer::shutdown() {
+    {
+        std::lock_guard lock(_mutex);
+        if (_stopping)
+            return;
+        _stopping = true;
+    }
+    _workAvailable.notify_all();
+    if (_worker.joinable())
+        _worker.join();
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "VulkanCommon.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+class PackFile;
+class UploadManager;
+class FrameArena;
+
+/*
+On-demand asset streaming from the memory-mapped pack into GPU buffers. Resident
+memory stays inside the 2 GB budget of the embedded units because nothing is
+front-loaded: queueBuffer() asks for an asset, a worker thread pre-faults its
+pages from the mapping (the page faults land on the worker, not the frame
+thread), and pump() - called once per frame from the main thread - feeds the
+pre-faulted requests into the transfer-queue upload path under a per-frame byte
+budget so a burst of requests never turns into a frame hitch.
+
+Tickets flip to staged once the copy batch is on the transfer queue; the frame
+that first consumes the data chains UploadManager::graphicsWaitInfo() as usual.
+*/
+class AssetStreamer {
+public:
+
+    using Ticket = uint64_t;
+
+    void init(const PackFile& pack);
+
+    //Requests an asset copy into dstBuffer at dstOffset; returns 0 if the asset is missing
+    Ticket queueBuffer(std::string_view name, vk::Buffer dstBuffer, vk::DeviceSize dstOffset);
+
+    //Stages pre-faulted requests into the upload batch, at most maxBytesPerFrame per call.
+    //The batch scratch list comes from the frame arena, so a pump never mallocs.
+    void pump(UploadManager& uploads, FrameArena& arena, vk::DeviceSize maxBytesPerFrame = 8ull * 1024 * 1024);
+
+    bool isStaged(Ticket ticket) const;
+
+    //Joins the worker; pending requests are dropped
+    void shutdown();
+
+    ~AssetStreamer() { shutdown(); }
+
+private:
+
+    struct Request {
+        Ticket ticket = 0;
+        const std::byte* data = nullptr;
+        vk::DeviceSize size = 0;
+        vk::Buffer dstBuffer;
+        vk::DeviceSize dstOffset = 0;
+    };
+
+    void workerLoop();
+
+    const PackFile* _pack = nullptr;
+
+    std::deque<Request> _pending;    //waiting for the worker to pre-fault
+    std::deque<Request> _prefetched; //ready for pump() to stage
+    std::unordered_set<Ticket> _staged;
+    Ticket _nextTicket = 1;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _workAvailable;
+    bool _stopping = false;
+    std::jthread _worker;
+};
@@ -0,0 +1,180 @@
+#include "AsyncCompute.hpp"
+
+#include "ShaderCache.hpp"
+#include "PipelineCacheStore.hpp"
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+
+void AsyncCompute::init(const vk::raii::Device& device,
+                        uint32_t computeQueueFamilyIndex,
+                        uint32_t graphicsQueueFamilyIndex,
+                        ShaderCache& shaderCache,
+                        PipelineCacheStore& pipelineCacheStore) {
+
+    _device = &device;
+    _shaderCache = &shaderCache;
+    _pipelineCacheStore = &pipelineCacheStore;
+    _computeQueueFamilyIndex = computeQueueFamilyIndex;
+    _graphicsQueueFamilyIndex = graphicsQueueFamilyIndex;
+    _queue = vk::raii::Queue(device, computeQueueFamilyIndex, 0);
+
+    vk::SemaphoreTypeCreateInfo timelineTypeInfo{ .semaphoreType = vk::SemaphoreType::eTimeline, .initialValue = 0 };
+    _timelineSemaphore = vk::raii::Semaphore(device, vk::SemaphoreCreateInfo{ .pNext = &timelineTypeInfo });
+
+    _currentBatch = takeFreshBatch();
+}
+
+AsyncCompute::PipelineHandle AsyncCompute::createPipeline(const std::string& spirvFile,
+                                                          std::span<const vk::DescriptorSetLayout> setLayouts,
+                                                          uint32_t pushConstantBytes) {
+
+    if (!std::filesystem::exists(spirvFile))
+        return {};
+
+    Pipeline pipeline;
+    pipeline.pushConstantBytes = pushConstantBytes;
+
+    const vk::PushConstantRange pushRange{ .stageFlags = vk::ShaderStageFlagBits::eCompute, .size = pushConstantBytes };
+    pipeline.layout = vk::raii::PipelineLayout(*_device, vk::PipelineLayoutCreateInfo{
+        .setLayoutCount = static_cast<uint32_t>(setLayouts.size()),
+        .pSetLayouts = setLayouts.data(),
+        .pushConstantRangeCount = (pushConstantBytes > 0) ? 1u : 0u,
+        .pPushConstantRanges = (pushConstantBytes > 0) ? &pushRange : nullptr });
+
+    pipeline.pipeline = vk::raii::Pipeline(*_device, _pipelineCacheStore->cache(), vk::ComputePipelineCreateInfo{
+        .stage = { .stage = vk::ShaderStageFlagBits::eCompute,
+                   .module = _shaderCache->get(spirvFile), .pName = "main" },
+        .layout = pipeline.layout });
+
+    _pipelines.push_back(std::move(pipeline));
+    return PipelineHandle{ static_cast<uint32_t>(_pipelines.size() - 1) };
+}
+
+vk::PipelineLayout AsyncCompute::pipelineLayout(PipelineHandle handle) const {
+    return _pipelines[handle.index].layout;
+}
+
+AsyncCompute::Batch AsyncCompute::takeFreshBatch() {
+
+    if (!_freeBatches.empty())
+    {
+        Batch batch = std::move(_freeBatches.back());
+        _freeBatches.pop_back();
+        return batch;
+    }
+
+    Batch batch;
+    batch.commandPool = vk::raii::CommandPool(*_device, vk::CommandPoolCreateInfo{ .queueFamilyIndex = _computeQueueFamilyIndex });
+    return batch;
+}
+
+void AsyncCompute::reclaimCompletedBatches() {
+
+    const uint64_t completed = _timelineSemaphore.getCounterValue();
+    while (!_inFlightBatches.empty() && _inFlightBatches.front().batchValue <= completed)
+    {
+        Batch batch = std::move(_inFlightBatches.front());
+        _inFlightBatches.pop_front();
+
+        batch.commandPool.reset();
+        batch.used = 0;
+        batch.batchValue = 0;
+        _freeBatches.push_back(std::move(batch));
+    }
+}
+
+uint64_t AsyncCompute::enqueue(const RecordFunction& record) {
+
+    Batch& batch = _currentBatch;
+    if (batch.used == batch.commandBuffers.size())
+    {
+        vk::CommandBufferAllocateInfo allocateInfo{ .commandPool = batch.commandPool,
+                                                    .level = vk::CommandBufferLevel::ePrimary,
+                                                    .commandBufferCount = 1 };
+        batch.commandBuffers.push_back(std::move(vk::raii::CommandBuffers(*_device, allocateInfo).front()));
+    }
+
+    const vk::raii::CommandBuffer& commandBuffer = batch.commandBuffers[batch.used++];
+    commandBuffer.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    record(commandBuffer);
+    commandBuffer.end();
+
+    //The next flush signals this value
+    return _batchCounter + 1;
+}
+
+uint64_t AsyncCompute::dispatch(PipelineHandle handle,
+                                std::span<const vk::DescriptorSet> sets,
+                                uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ,
+                                const void* pushData, uint32_t pushBytes) {
+
+    const Pipeline& pipeline = _pipelines[handle.index];
+
+    //Copy the push constants now - the caller's data will not outlive this call
+    std::array<std::byte, 128> pushCopy{}; //128 bytes is the guaranteed maxPushConstantsSize
+    if (pushBytes > 0)
+        std::memcpy(pushCopy.data(), pushData, pushBytes);
+
+    return enqueue([this, &pipeline, sets = std::vector(sets.begin(), sets.end()),
+                    groupsX, groupsY, groupsZ, pushCopy, pushBytes](const vk::raii::CommandBuffer& commandBuffer)
+    {
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline.pipeline);
+        if (!sets.empty())
+            commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipeline.layout, 0, sets, {});
+        if (pushBytes > 0)
+            commandBuffer.pushConstants<std::byte>(pipeline.layout, vk::ShaderStageFlagBits::eCompute, 0,
+                                                   vk::ArrayProxy<const std::byte>(pushBytes, pushCopy.data()));
+        commandBuffer.dispatch(groupsX, groupsY, groupsZ);
+    });
+}
+
+void AsyncCompute::flush(std::span<const vk::SemaphoreSubmitInfo> waits) {
+
+    reclaimCompletedBatches();
+
+    if (_currentBatch.used == 0)
+        return;
+
+    _batchCounter++;
+    _currentBatch.batchValue = _batchCounter;
+
+    std::vector<vk::CommandBufferSubmitInfo> commandBufferInfos;
+    commandBufferInfos.reserve(_currentBatch.used);
+    for (uint32_t i = 0; i < _currentBatch.used; i++)
+        commandBufferInfos.push_back(vk::CommandBufferSubmitInfo{ .commandBuffer = _currentBatch.commandBuffers[i] });
+
+    vk::SemaphoreSubmitInfo signalInfo{ .semaphore = _timelineSemaphore,
+                                        .value = _batchCounter,
+                                        .stageMask = vk::PipelineStageFlagBits2::eAllCommands };
+    _queue.submit2(vk::SubmitInfo2{ .waitSemaphoreInfoCount = static_cast<uint32_t>(waits.size()),
+                                    .pWaitSemaphoreInfos = waits.data(),
+                                    .commandBufferInfoCount = static_cast<uint32_t>(commandBufferInfos.size()),
+                                    .pCommandBufferInfos = commandBufferInfos.data(),
+                                    .signalSemaphoreInfoCount = 1,
+                                    .pSignalSemaphoreInfos = &signalInfo });
+
+    _inFlightBatches.push_back(std::move(_currentBatch));
+    _currentBatch = takeFreshBatch();
+}
+
+vk::SemaphoreSubmitInfo AsyncCompute::graphicsWaitInfo() const {
+    return vk::SemaphoreSubmitInfo{ .semaphore = _timelineSemaphore,
+                                    .value = _batchCounter,
+                                    .stageMask = vk::PipelineStageFlagBits2::eAllCommands };
+}
+
+bool AsyncCompute::isComplete(uint64_t ticket) const {
+    return _timelineSemaphore.getCounterValue() >= ticket;
+}
+
+void AsyncCompute::wait(uint64_t ticket) const {
+
+    vk::Semaphore timelineSemaphore = _timelineSemaphore;
+    vk::SemaphoreWaitInfo waitInfo{ .semaphoreCount = 1,
+                                    .pSemaphores = &timelineSemaphore,
+                                    .pValues = &ticket };
+    while (_device->waitSemaphores(waitInfo, UINT64_MAX) == vk::Result::eTimeout)
+        ;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "VulkanCommon.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+class ShaderCache;
+class PipelineCacheStore;
+
+/*
+Compute pipelines and dispatch batching on the dedicated compute queue. Where
+the hardware exposes a compute-capable family distinct from graphics (the
+async compute engines on the RDNA2 parts in the fleet), batches submitted here
+execute in the graphics queue's bubbles - post-processing and particle
+simulation overlap next-frame shadow rendering instead of serializing after it.
+Without a distinct family everything still works on the shared queue; only the
+overlap disappears.
+
+Recording mirrors SubmitManager: enqueue()/dispatch() record into the current
+batch immediately, flush() pushes one submit2 per frame and signals a timeline
+semaphore. Cross-queue ordering is plain semaphore plumbing - pass the graphics
+waits the batch must respect into flush(), and chain graphicsWaitInfo() into
+the graphics submit that consumes the results. Resources read by both queues
+should be created with concurrent sharing; ownership transfers are not managed
+here.
+*/
+class AsyncCompute {
+public:
+
+    using RecordFunction = std::function<void(const vk::raii::CommandBuffer&)>;
+
+    struct PipelineHandle {
+        uint32_t index = UINT32_MAX;
+        bool valid() const { return index != UINT32_MAX; }
+    };
+
+    void init(const vk::raii::Device& device,
+              uint32_t computeQueueFamilyIndex,
+              uint32_t graphicsQueueFamilyIndex,
+              ShaderCache& shaderCache,
+              PipelineCacheStore& pipelineCacheStore);
+
+    bool hasDedicatedQueue() const { return _computeQueueFamilyIndex != _graphicsQueueFamilyIndex; }
+    const vk::raii::Queue& queue() const { return _queue; }
+
+    //Builds a compute pipeline from offline-compiled SPIR-V; invalid handle when the file is missing
+    PipelineHandle createPipeline(const std::string& spirvFile,
+                                  std::span<const vk::DescriptorSetLayout> setLayouts,
+                                  uint32_t pushConstantBytes = 0);
+
+    vk::PipelineLayout pipelineLayout(PipelineHandle handle) const;
+
+    //Arbitrary compute-queue commands (barriers, clears) into the current batch
+    uint64_t enqueue(const RecordFunction& record);
+
+    //Bind + descriptors + push constants + dispatch, the common case in one call
+    uint64_t dispatch(PipelineHandle handle,
+                      std::span<const vk::DescriptorSet> sets,
+                      uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ,
+                      const void* pushData = nullptr, uint32_t pushBytes = 0);
+
+    /*Submits the batch on the compute queue, waiting on the given graphics-side
+      semaphores first (empty span = start as early as the queue allows). Once per
+      frame; no-op when nothing was recorded.*/
+    void flush(std::span<const vk::SemaphoreSubmitInfo> waits = {});
+
+    //Wait to chain into the graphics submit that consumes the last flushed batch
+    vk::SemaphoreSubmitInfo graphicsWaitInfo() const;
+
+    bool isComplete(uint64_t ticket) const;
+    void wait(uint64_t ticket) const;
+
+private:
+
+    struct Batch {
+        vk::raii::CommandPool commandPool = nullptr;
+        std::vector<vk::raii::CommandBuffer> commandBuffers;
+        uint32_t used = 0;
+        uint64_t batchValue = 0;
+    };
+
+    struct Pipeline {
+        vk::raii::PipelineLayout layout = nullptr;
+        vk::raii::Pipeline pipeline = nullptr;
+        uint32_t pushConstantBytes = 0;
+    };
+
+    Batch takeFreshBatch();
+    void reclaimCompletedBatches();
+
+    const vk::raii::Device* _device = nullptr;
+    ShaderCache* _shaderCache = nullptr;
+    PipelineCacheStore* _pipelineCacheStore = nullptr;
+    uint32_t _computeQueueFamilyIndex = 0;
+    uint32_t _graphicsQueueFamilyIndex = 0;
+    vk::raii::Queue _queue = nullptr;
+
+    std::vector<Pipeline> _pipelines;
+
+    vk::raii::Semaphore _timelineSemaphore = nullptr;
+    uint64_t _batchCounter = 0;
+    Batch _currentBatch;
+    std::deque<Batch> _inFlightBatches;
+    std::vector<Batch> _freeBatches;
+};
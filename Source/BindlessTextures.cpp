@@ -0,0 +1,109 @@
+#include "BindlessTextures.hpp"
+
+#include <stdexcept>
+
+void BindlessTextures::init(const vk::raii::Device& device, bool descriptorIndexingAvailable) {
+
+    _device = &device;
+    _supported = descriptorIndexingAvailable;
+    if (!_supported)
+        return; //callers fall back to per-draw descriptor sets from DescriptorAllocator
+
+    /*Partially bound: slots we have not written yet are legal as long as no shader
+      reads them. Update-after-bind: we can write slots while previous frames that
+      bound this set are still in flight. Variable count lets the one set carry the
+      full Capacity without forcing every pipeline layout to match it exactly.*/
+    constexpr vk::DescriptorBindingFlags bindingFlags =
+        vk::DescriptorBindingFlagBits::ePartiallyBound |
+        vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+        vk::DescriptorBindingFlagBits::eVariableDescriptorCount;
+
+    vk::DescriptorSetLayoutBinding binding{
+        .binding = 0,
+        .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+        .descriptorCount = Capacity,
+        .stageFlags = vk::ShaderStageFlagBits::eAll
+    };
+    vk::StructureChain layoutChain{
+        vk::DescriptorSetLayoutCreateInfo{
+            .flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+            .bindingCount = 1,
+            .pBindings = &binding
+        },
+        vk::DescriptorSetLayoutBindingFlagsCreateInfo{
+            .bindingCount = 1,
+            .pBindingFlags = &bindingFlags
+        }
+    };
+    _layout = vk::raii::DescriptorSetLayout(device, layoutChain.get<vk::DescriptorSetLayoutCreateInfo>());
+
+    vk::DescriptorPoolSize poolSize{
+        .type = vk::DescriptorType::eCombinedImageSampler,
+        .descriptorCount = Capacity
+    };
+    vk::DescriptorPoolCreateInfo poolInfo{
+        .flags = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind,
+        .maxSets = 1,
+        .poolSizeCount = 1,
+        .pPoolSizes = &poolSize
+    };
+    _pool = vk::raii::DescriptorPool(device, poolInfo);
+
+    //One set for the whole app lifetime - freed with the pool, so allocate the raw handle
+    const uint32_t variableCount = Capacity;
+    vk::DescriptorSetLayout layout = _layout;
+    vk::StructureChain allocateChain{
+        vk::DescriptorSetAllocateInfo{
+            .descriptorPool = _pool,
+            .descriptorSetCount = 1,
+            .pSetLayouts = &layout
+        },
+        vk::DescriptorSetVariableDescriptorCountAllocateInfo{
+            .descriptorSetCount = 1,
+            .pDescriptorCounts = &variableCount
+        }
+    };
+    _set = vk::Device(*device).allocateDescriptorSets(allocateChain.get<vk::DescriptorSetAllocateInfo>()).front();
+}
+
+uint32_t BindlessTextures::add(vk::ImageView imageView, vk::Sampler sampler) {
+
+    if (!_supported)
+        throw std::runtime_error("bindless textures unavailable on this device");
+
+    uint32_t index;
+    if (!_freeSlots.empty())
+    {
+        index = _freeSlots.back();
+        _freeSlots.pop_back();
+    }
+    else
+    {
+        if (_highWatermark == Capacity)
+            throw std::runtime_error("bindless texture table exhausted");
+        index = _highWatermark++;
+    }
+
+    vk::DescriptorImageInfo imageInfo{
+        .sampler = sampler,
+        .imageView = imageView,
+        .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal
+    };
+    vk::WriteDescriptorSet write{
+        .dstSet = _set,
+        .dstBinding = 0,
+        .dstArrayElement = index,
+        .descriptorCount = 1,
+        .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+        .pImageInfo = &imageInfo
+    };
+    _device->updateDescriptorSets(write, nullptr);
+
+    return index;
+}
+
+void BindlessTextures::remove(uint32_t index) {
+    /*Partially bound means a stale slot is harmless until reused - no need to
+      write a null descriptor, just recycle the index.*/
+    _freeSlots.push_back(index);
+}
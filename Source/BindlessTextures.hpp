@@ -0,0 +1,51 @@
+#pragma once
+
+#include "VulkanCommon.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/*
+Bindless texture table: one big sampled-image array in a single descriptor set,
+bound once per frame, with materials carrying plain uint32_t indices into it.
+Draws no longer break batches when the texture changes, which is what lets the
+draw-call merging elsewhere collapse thousands of draws into a few hundred
+multi-draw batches.
+
+Built on descriptor indexing (partially-bound + update-after-bind + variable
+count), which createLogicalDevice() enables when the hardware has it; check
+supported() before wiring pipelines to the table. Slots are recycled through a
+free list - update-after-bind means writing a slot never requires the set to be
+idle.
+*/
+class BindlessTextures {
+public:
+
+    static constexpr uint32_t Capacity = 4096;
+
+    //No-op (supported() == false) when the device lacks descriptor indexing
+    void init(const vk::raii::Device& device, bool descriptorIndexingAvailable);
+
+    bool supported() const { return _supported; }
+
+    //Writes the texture into a free slot and returns its index for material data
+    uint32_t add(vk::ImageView imageView, vk::Sampler sampler);
+
+    //Releases the slot for reuse. The caller guarantees no in-flight frame still indexes it.
+    void remove(uint32_t index);
+
+    vk::DescriptorSetLayout layout() const { return _layout; }
+    vk::DescriptorSet descriptorSet() const { return _set; }
+
+private:
+
+    const vk::raii::Device* _device = nullptr;
+    bool _supported = false;
+
+    vk::raii::DescriptorSetLayout _layout = nullptr;
+    vk::raii::DescriptorPool _pool = nullptr;
+    vk::DescriptorSet _set;
+
+    std::vector<uint32_t> _freeSlots;
+    uint32_t _highWatermark = 0; //slots handed out before the free list had anything
+};
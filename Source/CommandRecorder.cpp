@@ -0,0 +1,104 @@
+#include "CommandRecorder.hpp"
+
+#include "JobSystem.hpp"
+
+#include <thread>
+
+void CommandRecorder::init(const vk::raii::Device& device, uint32_t queueFamilyIndex,
+                           JobSystem* jobSystem, uint32_t workerCount) {
+
+    _device = &device;
+    _jobSystem = jobSystem;
+    if (workerCount != 0)
+        _workerCount = workerCount;
+    else if (jobSystem != nullptr)
+        _workerCount = jobSystem->workerCount() + 1; //the waiting thread records a chunk too
+    else
+        _workerCount = std::max(1u, std::thread::hardware_concurrency());
+
+    for (auto& slotPools : _workerPools)
+    {
+        slotPools.clear();
+        for (uint32_t worker = 0; worker < _workerCount; worker++)
+        {
+            WorkerPool workerPool;
+            workerPool.commandPool = vk::raii::CommandPool(device, vk::CommandPoolCreateInfo{ .queueFamilyIndex = queueFamilyIndex });
+            slotPools.push_back(std::move(workerPool));
+        }
+    }
+}
+
+void CommandRecorder::beginFrame(uint32_t frameSlot) {
+
+    _currentSlot = frameSlot;
+    for (auto& workerPool : _workerPools[_currentSlot])
+    {
+        //Resetting the pool returns every buffer allocated from it to the initial
+        //state in one call, instead of resetting buffers one by one.
+        workerPool.commandPool.reset();
+        workerPool.usedThisFrame = 0;
+    }
+}
+
+const vk::raii::CommandBuffer& CommandRecorder::acquireSecondaryBuffer(WorkerPool& workerPool) {
+
+    if (workerPool.usedThisFrame == workerPool.commandBuffers.size())
+    {
+        vk::CommandBufferAllocateInfo allocateInfo{ .commandPool = workerPool.commandPool,
+                                                    .level = vk::CommandBufferLevel::eSecondary,
+                                                    .commandBufferCount = 1 };
+        workerPool.commandBuffers.push_back(std::move(vk::raii::CommandBuffers(*_device, allocateInfo).front()));
+    }
+    return workerPool.commandBuffers[workerPool.usedThisFrame++];
+}
+
+void CommandRecorder::recordAndExecute(const vk::raii::CommandBuffer& primary,
+                                       const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+                                       std::span<const RecordFunction> jobs) {
+    if (jobs.empty())
+        return;
+
+    const uint32_t activeWorkers = std::min<uint32_t>(_workerCount, static_cast<uint32_t>(jobs.size()));
+    const size_t chunkSize = (jobs.size() + activeWorkers - 1) / activeWorkers;
+
+    std::vector<vk::CommandBuffer> secondaries(activeWorkers);
+
+    const auto recordChunk = [&, chunkSize](uint32_t worker)
+    {
+        const size_t firstJob = worker * chunkSize;
+        const size_t lastJob = std::min(firstJob + chunkSize, jobs.size());
+
+        //Each chunk has its own pool, so it does not matter which thread records it
+        const vk::raii::CommandBuffer& secondary = acquireSecondaryBuffer(_workerPools[_currentSlot][worker]);
+        secondary.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+                                                    .pInheritanceInfo = &inheritanceInfo });
+        for (size_t job = firstJob; job < lastJob; job++)
+            jobs[job](secondary);
+        secondary.end();
+
+        secondaries[worker] = secondary;
+    };
+
+    if (_jobSystem != nullptr)
+    {
+        //Chunks 1..N go to the scheduler; this thread records chunk 0 and then helps
+        std::vector<JobSystem::JobHandle> handles;
+        handles.reserve(activeWorkers - 1);
+        for (uint32_t worker = 1; worker < activeWorkers; worker++)
+            handles.push_back(_jobSystem->schedule([&recordChunk, worker] { recordChunk(worker); }));
+
+        recordChunk(0);
+        for (const JobSystem::JobHandle handle : handles)
+            _jobSystem->wait(handle);
+    }
+    else
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(activeWorkers);
+        for (uint32_t worker = 0; worker < activeWorkers; worker++)
+            workers.emplace_back([&recordChunk, worker] { recordChunk(worker); });
+        //jthreads join here, after which every secondary buffer is fully recorded
+    }
+
+    primary.executeCommands(secondaries);
+}
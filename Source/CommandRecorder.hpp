@@ -0,0 +1,63 @@
+#pragma once
+
+#include "VulkanCommon.hpp"
+#include "FrameEngine.hpp"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+class JobSystem;
+
+/*
+Parallel command recording. Command pools are externally synchronized objects, so the
+only way to record from several threads without locking is one pool per worker thread.
+Workers record disjoint chunks of the frame's draw jobs into secondary command buffers,
+which the main thread stitches into the primary buffer with executeCommands before
+submit.
+
+Pools exist per worker *and* per frame slot so a worker can record frame N+1 while
+frame N's buffers are still in flight on the GPU. Secondary buffers are allocated on
+demand and reused after a pool reset, so steady-state frames allocate nothing.
+*/
+class CommandRecorder {
+public:
+
+    using RecordFunction = std::function<void(const vk::raii::CommandBuffer&)>;
+
+    /*workerCount of 0 means one worker per hardware thread. With a job system the
+      chunks run as jobs on its workers (plus the calling thread, which helps while
+      waiting); without one, threads are spawned per call.*/
+    void init(const vk::raii::Device& device, uint32_t queueFamilyIndex,
+              JobSystem* jobSystem = nullptr, uint32_t workerCount = 0);
+
+    //Resets every worker pool belonging to the given frame slot. Call once per frame before recording.
+    void beginFrame(uint32_t frameSlot);
+
+    /*Splits the jobs into one contiguous chunk per worker, records each chunk into a
+      secondary command buffer on its own thread, then executes them from the primary
+      buffer in job order.*/
+    void recordAndExecute(const vk::raii::CommandBuffer& primary,
+                          const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+                          std::span<const RecordFunction> jobs);
+
+    uint32_t workerCount() const { return _workerCount; }
+
+private:
+
+    struct WorkerPool {
+        vk::raii::CommandPool commandPool = nullptr;
+        std::vector<vk::raii::CommandBuffer> commandBuffers; //grown on demand, recycled by pool reset
+        uint32_t usedThisFrame = 0;
+    };
+
+    const vk::raii::CommandBuffer& acquireSecondaryBuffer(WorkerPool& workerPool);
+
+    const vk::raii::Device* _device = nullptr;
+    JobSystem* _jobSystem = nullptr;
+    uint32_t _workerCount = 0;
+    uint32_t _currentSlot = 0;
+    std::array<std::vector<WorkerPool>, FrameEngine::MaxFramesInFlight> _workerPools; //[frameSlot][worker]
+};
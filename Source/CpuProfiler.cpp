@@ -0,0 +1,44 @@
+#include "CpuProfiler.hpp"
+
+void CpuProfiler::beginScope(const char* name) {
+
+    Node& parent = _openScopes.empty() ? _root : *_openScopes.back();
+    parent.children.push_back(Node{ .name = name });
+
+    /*Pointers in _openScopes stay valid: we only ever append to the children of the
+      deepest open node, and no open ancestor lives inside that vector.*/
+    _openScopes.push_back(&parent.children.back());
+    _startTimes.push_back(std::chrono::steady_clock::now());
+}
+
+void CpuProfiler::endScope() {
+
+    const auto elapsed = std::chrono::steady_clock::now() - _startTimes.back();
+    _openScopes.back()->milliseconds = std::chrono::duration<double, std::milli>(elapsed).count();
+
+    _openScopes.pop_back();
+    _startTimes.pop_back();
+}
+
+nlohmann::json CpuProfiler::report() const {
+
+    auto nodeToJson = [](this auto&& self, const Node& node) -> nlohmann::json {
+        nlohmann::json json = { {"name", node.name}, {"ms", node.milliseconds} };
+        if (!node.children.empty())
+        {
+            json["children"] = nlohmann::json::array();
+            for (const Node& child : node.children)
+                json["children"].push_back(self(child));
+        }
+        return json;
+    };
+
+    nlohmann::json report = nlohmann::json::array();
+    for (const Node& child : _root.children)
+        report.push_back(nodeToJson(child));
+    return report;
+}
+
+void CpuProfiler::reset() {
+    _root.children.clear();
+}
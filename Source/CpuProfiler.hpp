@@ -0,0 +1,63 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/*
+Scoped CPU timers with nesting, reported as structured JSON. Used first for the
+startup sequence - our field units show seconds of startup variance across driver
+versions and without per-phase numbers there is no telling whether it is device
+enumeration or swapchain creation - but scopes nest, so the same surface works for
+frame phases as they appear.
+
+Usage:
+    {
+        auto timer = profiler.scope("createSwapChain");
+        createSwapChain();
+    }
+    std::cout << profiler.report().dump(2);
+*/
+class CpuProfiler {
+public:
+
+    //RAII handle: the scope ends when this goes out of... scope
+    class Scope {
+    public:
+        Scope(CpuProfiler& profiler, const char* name) : _profiler(&profiler) { profiler.beginScope(name); }
+        ~Scope() { if (_profiler) _profiler->endScope(); }
+
+        Scope(Scope&& other) noexcept : _profiler(other._profiler) { other._profiler = nullptr; }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope& operator=(Scope&&) = delete;
+
+    private:
+        CpuProfiler* _profiler;
+    };
+
+    [[nodiscard]] Scope scope(const char* name) { return Scope(*this, name); }
+
+    void beginScope(const char* name);
+    void endScope();
+
+    //Hierarchical timing report: [{"name":..., "ms":..., "children":[...]}, ...]
+    nlohmann::json report() const;
+
+    //Drops all recorded scopes (scopes must all be closed)
+    void reset();
+
+private:
+
+    struct Node {
+        std::string name;
+        double milliseconds = 0.0;
+        std::vector<Node> children;
+    };
+
+    Node _root;
+    std::vector<Node*> _openScopes; //ancestor chain of the currently open scope
+    std::vector<std::chrono::steady_clock::time_point> _startTimes;
+};
@@ -0,0 +1,373 @@
+#include "DepthPyramid.hpp"
+
+#include "ShaderCache.hpp"
+#include "PipelineCacheStore.hpp"
+#include "DescriptorAllocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <filesystem>
+#include <stdexcept>
+
+namespace {
+    constexpr const char* DownsampleShader = "Shaders/hiz_downsample.comp.spv";
+    constexpr const char* CullShader = "Shaders/occlusion_cull.comp.spv";
+
+    uint32_t groupCount(uint32_t size, uint32_t groupSize) {
+        return (size + groupSize - 1) / groupSize;
+    }
+}
+
+void DepthPyramid::init(const vk::raii::Device& device,
+                        const vk::raii::PhysicalDevice& physicalDevice,
+                        GpuAllocator& allocator,
+                        ShaderCache& shaderCache,
+                        PipelineCacheStore& pipelineCacheStore) {
+
+    _device = &device;
+    _allocator = &allocator;
+    _shaderCache = &shaderCache;
+    _pipelineCacheStore = &pipelineCacheStore;
+    _depthFormat = pickDepthFormat(physicalDevice);
+
+    //Plain nearest sampler: the reduction happens in the shader, not in the sampler
+    _pointSampler = vk::raii::Sampler(device, vk::SamplerCreateInfo{
+        .magFilter = vk::Filter::eNearest,
+        .minFilter = vk::Filter::eNearest,
+        .mipmapMode = vk::SamplerMipmapMode::eNearest,
+        .addressModeU = vk::SamplerAddressMode::eClampToEdge,
+        .addressModeV = vk::SamplerAddressMode::eClampToEdge,
+        .addressModeW = vk::SamplerAddressMode::eClampToEdge,
+        .maxLod = vk::LodClampNone });
+
+    createPipelines();
+}
+
+vk::Format DepthPyramid::pickDepthFormat(const vk::raii::PhysicalDevice& physicalDevice) {
+
+    /*D32 first: no stencil baggage and the pyramid reads it directly. The packed
+      formats are the fallback for hardware without a sampleable D32.*/
+    constexpr std::array candidates = { vk::Format::eD32Sfloat,
+                                        vk::Format::eD32SfloatS8Uint,
+                                        vk::Format::eD24UnormS8Uint };
+    for (const vk::Format format : candidates)
+    {
+        const auto features = physicalDevice.getFormatProperties(format).optimalTilingFeatures;
+        if ((features & vk::FormatFeatureFlagBits::eDepthStencilAttachment) &&
+            (features & vk::FormatFeatureFlagBits::eSampledImage))
+            return format;
+    }
+    throw std::runtime_error("no depth format supports attachment + sampling");
+}
+
+void DepthPyramid::createPipelines() {
+
+    //Missing bytecode disables culling but never the depth target itself
+    if (!std::filesystem::exists(DownsampleShader) || !std::filesystem::exists(CullShader))
+        return;
+
+    _shaderCache->preload(DownsampleShader);
+    _shaderCache->preload(CullShader);
+
+    {
+        const std::array bindings = {
+            vk::DescriptorSetLayoutBinding{ .binding = 0, .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                                            .descriptorCount = 1, .stageFlags = vk::ShaderStageFlagBits::eCompute },
+            vk::DescriptorSetLayoutBinding{ .binding = 1, .descriptorType = vk::DescriptorType::eStorageImage,
+                                            .descriptorCount = 1, .stageFlags = vk::ShaderStageFlagBits::eCompute } };
+        _downsampleSetLayout = vk::raii::DescriptorSetLayout(*_device, vk::DescriptorSetLayoutCreateInfo{
+            .bindingCount = static_cast<uint32_t>(bindings.size()), .pBindings = bindings.data() });
+
+        vk::DescriptorSetLayout setLayout = _downsampleSetLayout;
+        const vk::PushConstantRange pushRange{ .stageFlags = vk::ShaderStageFlagBits::eCompute,
+                                               .size = sizeof(DownsamplePush) };
+        _downsampleLayout = vk::raii::PipelineLayout(*_device, vk::PipelineLayoutCreateInfo{
+            .setLayoutCount = 1, .pSetLayouts = &setLayout,
+            .pushConstantRangeCount = 1, .pPushConstantRanges = &pushRange });
+    }
+
+    {
+        const std::array bindings = {
+            vk::DescriptorSetLayoutBinding{ .binding = 0, .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                                            .descriptorCount = 1, .stageFlags = vk::ShaderStageFlagBits::eCompute },
+            vk::DescriptorSetLayoutBinding{ .binding = 1, .descriptorType = vk::DescriptorType::eStorageBuffer,
+                                            .descriptorCount = 1, .stageFlags = vk::ShaderStageFlagBits::eCompute },
+            vk::DescriptorSetLayoutBinding{ .binding = 2, .descriptorType = vk::DescriptorType::eStorageBuffer,
+                                            .descriptorCount = 1, .stageFlags = vk::ShaderStageFlagBits::eCompute } };
+        _cullSetLayout = vk::raii::DescriptorSetLayout(*_device, vk::DescriptorSetLayoutCreateInfo{
+            .bindingCount = static_cast<uint32_t>(bindings.size()), .pBindings = bindings.data() });
+
+        vk::DescriptorSetLayout setLayout = _cullSetLayout;
+        const vk::PushConstantRange pushRange{ .stageFlags = vk::ShaderStageFlagBits::eCompute,
+                                               .size = sizeof(CullParams) };
+        _cullLayout = vk::raii::PipelineLayout(*_device, vk::PipelineLayoutCreateInfo{
+            .setLayoutCount = 1, .pSetLayouts = &setLayout,
+            .pushConstantRangeCount = 1, .pPushConstantRanges = &pushRange });
+    }
+
+    _downsamplePipeline = vk::raii::Pipeline(*_device, _pipelineCacheStore->cache(), vk::ComputePipelineCreateInfo{
+        .stage = { .stage = vk::ShaderStageFlagBits::eCompute,
+                   .module = _shaderCache->get(DownsampleShader), .pName = "main" },
+        .layout = _downsampleLayout });
+    _cullPipeline = vk::raii::Pipeline(*_device, _pipelineCacheStore->cache(), vk::ComputePipelineCreateInfo{
+        .stage = { .stage = vk::ShaderStageFlagBits::eCompute,
+                   .module = _shaderCache->get(CullShader), .pName = "main" },
+        .layout = _cullLayout });
+
+    _cullingAvailable = true;
+}
+
+void DepthPyramid::releaseTargets() {
+
+    _pyramidMipViews.clear();
+    _pyramidFullView = nullptr;
+    _depthView = nullptr;
+
+    if (static_cast<bool>(*_depthImage))
+    {
+        _depthImage = nullptr;
+        _allocator->free(_depthAllocation);
+    }
+    if (static_cast<bool>(*_pyramidImage))
+    {
+        _pyramidImage = nullptr;
+        _allocator->free(_pyramidAllocation);
+    }
+}
+
+void DepthPyramid::create(vk::Extent2D extent) {
+
+    releaseTargets(); //resize path; the caller has already waited for in-flight frames
+
+    _extent = extent;
+    _mipCount = std::bit_width(std::max(extent.width, extent.height));
+
+    _depthImage = vk::raii::Image(*_device, vk::ImageCreateInfo{
+        .imageType = vk::ImageType::e2D,
+        .format = _depthFormat,
+        .extent = { .width = extent.width, .height = extent.height, .depth = 1 },
+        .mipLevels = 1,
+        .arrayLayers = 1,
+        .samples = vk::SampleCountFlagBits::e1,
+        .tiling = vk::ImageTiling::eOptimal,
+        .usage = vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst,
+        .sharingMode = vk::SharingMode::eExclusive,
+        .initialLayout = vk::ImageLayout::eUndefined });
+    _depthAllocation = _allocator->allocate(_depthImage.getMemoryRequirements(), vk::MemoryPropertyFlagBits::eDeviceLocal);
+    _depthImage.bindMemory(_depthAllocation.memory, _depthAllocation.offset);
+
+    //The pyramid reads depth only, even when the format carries stencil
+    _depthView = vk::raii::ImageView(*_device, vk::ImageViewCreateInfo{
+        .image = _depthImage,
+        .viewType = vk::ImageViewType::e2D,
+        .format = _depthFormat,
+        .subresourceRange = { .aspectMask = vk::ImageAspectFlagBits::eDepth,
+                              .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 } });
+
+    _pyramidImage = vk::raii::Image(*_device, vk::ImageCreateInfo{
+        .imageType = vk::ImageType::e2D,
+        .format = vk::Format::eR32Sfloat,
+        .extent = { .width = extent.width, .height = extent.height, .depth = 1 },
+        .mipLevels = _mipCount,
+        .arrayLayers = 1,
+        .samples = vk::SampleCountFlagBits::e1,
+        .tiling = vk::ImageTiling::eOptimal,
+        .usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eStorage,
+        .sharingMode = vk::SharingMode::eExclusive,
+        .initialLayout = vk::ImageLayout::eUndefined });
+    _pyramidAllocation = _allocator->allocate(_pyramidImage.getMemoryRequirements(), vk::MemoryPropertyFlagBits::eDeviceLocal);
+    _pyramidImage.bindMemory(_pyramidAllocation.memory, _pyramidAllocation.offset);
+
+    _pyramidFullView = vk::raii::ImageView(*_device, vk::ImageViewCreateInfo{
+        .image = _pyramidImage,
+        .viewType = vk::ImageViewType::e2D,
+        .format = vk::Format::eR32Sfloat,
+        .subresourceRange = { .aspectMask = vk::ImageAspectFlagBits::eColor,
+                              .baseMipLevel = 0, .levelCount = _mipCount, .baseArrayLayer = 0, .layerCount = 1 } });
+    for (uint32_t mip = 0; mip < _mipCount; mip++)
+    {
+        _pyramidMipViews.emplace_back(*_device, vk::ImageViewCreateInfo{
+            .image = _pyramidImage,
+            .viewType = vk::ImageViewType::e2D,
+            .format = vk::Format::eR32Sfloat,
+            .subresourceRange = { .aspectMask = vk::ImageAspectFlagBits::eColor,
+                                  .baseMipLevel = mip, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 } });
+    }
+}
+
+void DepthPyramid::recordClear(const vk::raii::CommandBuffer& commandBuffer) {
+
+    const vk::ImageSubresourceRange depthRange{ .aspectMask = vk::ImageAspectFlagBits::eDepth,
+                                                .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 };
+    vk::ImageMemoryBarrier2 toClear{
+        .srcStageMask = vk::PipelineStageFlagBits2::eTopOfPipe,
+        .dstStageMask = vk::PipelineStageFlagBits2::eClear,
+        .dstAccessMask = vk::AccessFlagBits2::eTransferWrite,
+        .oldLayout = vk::ImageLayout::eUndefined,
+        .newLayout = vk::ImageLayout::eTransferDstOptimal,
+        .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+        .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+        .image = _depthImage,
+        .subresourceRange = depthRange };
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo{ .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &toClear });
+
+    commandBuffer.clearDepthStencilImage(_depthImage, vk::ImageLayout::eTransferDstOptimal,
+                                         vk::ClearDepthStencilValue{ .depth = 1.0f, .stencil = 0 }, depthRange);
+}
+
+void DepthPyramid::recordDownsample(const vk::raii::CommandBuffer& commandBuffer,
+                                    DescriptorAllocator& descriptors,
+                                    vk::ImageLayout depthCurrentLayout) {
+
+    if (!_cullingAvailable)
+        return;
+
+    //Depth to sampled-read; the source stage depends on who produced it
+    const bool fromClear = (depthCurrentLayout == vk::ImageLayout::eTransferDstOptimal);
+    vk::ImageMemoryBarrier2 depthToRead{
+        .srcStageMask = fromClear ? vk::PipelineStageFlagBits2::eClear : vk::PipelineStageFlagBits2::eLateFragmentTests,
+        .srcAccessMask = fromClear ? vk::AccessFlagBits2::eTransferWrite : vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+        .dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead,
+        .oldLayout = depthCurrentLayout,
+        .newLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+        .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+        .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+        .image = _depthImage,
+        .subresourceRange = { .aspectMask = vk::ImageAspectFlagBits::eDepth,
+                              .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 } };
+
+    /*Whole pyramid to eGeneral, contents discarded - every texel is rewritten this
+      frame. Source stage covers last frame's cull still reading it; same queue, so
+      this serializes correctly.*/
+    vk::ImageMemoryBarrier2 pyramidToWrite{
+        .srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+        .srcAccessMask = vk::AccessFlagBits2::eShaderSampledRead | vk::AccessFlagBits2::eShaderStorageWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+        .dstAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+        .oldLayout = vk::ImageLayout::eUndefined,
+        .newLayout = vk::ImageLayout::eGeneral,
+        .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+        .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+        .image = _pyramidImage,
+        .subresourceRange = { .aspectMask = vk::ImageAspectFlagBits::eColor,
+                              .baseMipLevel = 0, .levelCount = _mipCount, .baseArrayLayer = 0, .layerCount = 1 } };
+
+    const std::array initialBarriers = { depthToRead, pyramidToWrite };
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo{ .imageMemoryBarrierCount = static_cast<uint32_t>(initialBarriers.size()),
+                                                       .pImageMemoryBarriers = initialBarriers.data() });
+
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, _downsamplePipeline);
+
+    uint32_t mipWidth = _extent.width;
+    uint32_t mipHeight = _extent.height;
+    for (uint32_t mip = 0; mip < _mipCount; mip++)
+    {
+        const bool firstPass = (mip == 0);
+
+        //mip 0 copies the depth image; every later pass reduces the previous mip 2x2
+        vk::DescriptorImageInfo srcInfo{
+            .sampler = _pointSampler,
+            .imageView = firstPass ? vk::ImageView(_depthView) : vk::ImageView(_pyramidMipViews[mip - 1]),
+            .imageLayout = firstPass ? vk::ImageLayout::eShaderReadOnlyOptimal : vk::ImageLayout::eGeneral };
+        vk::DescriptorImageInfo dstInfo{
+            .imageView = _pyramidMipViews[mip],
+            .imageLayout = vk::ImageLayout::eGeneral };
+
+        const vk::DescriptorSet set = descriptors.allocateTransient(_downsampleSetLayout);
+        const std::array writes = {
+            vk::WriteDescriptorSet{ .dstSet = set, .dstBinding = 0, .descriptorCount = 1,
+                                    .descriptorType = vk::DescriptorType::eCombinedImageSampler, .pImageInfo = &srcInfo },
+            vk::WriteDescriptorSet{ .dstSet = set, .dstBinding = 1, .descriptorCount = 1,
+                                    .descriptorType = vk::DescriptorType::eStorageImage, .pImageInfo = &dstInfo } };
+        _device->updateDescriptorSets(writes, nullptr);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, _downsampleLayout, 0, { set }, {});
+
+        const DownsamplePush push{ .dstWidth = mipWidth, .dstHeight = mipHeight, .firstPass = firstPass ? 1u : 0u };
+        commandBuffer.pushConstants<DownsamplePush>(_downsampleLayout, vk::ShaderStageFlagBits::eCompute, 0, push);
+        commandBuffer.dispatch(groupCount(mipWidth, 8), groupCount(mipHeight, 8), 1);
+
+        //The mip just written becomes the next pass's sampled source
+        if (mip + 1 < _mipCount)
+        {
+            vk::ImageMemoryBarrier2 mipReady{
+                .srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+                .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+                .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+                .dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead,
+                .oldLayout = vk::ImageLayout::eGeneral,
+                .newLayout = vk::ImageLayout::eGeneral,
+                .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+                .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+                .image = _pyramidImage,
+                .subresourceRange = { .aspectMask = vk::ImageAspectFlagBits::eColor,
+                                      .baseMipLevel = mip, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 } };
+            commandBuffer.pipelineBarrier2(vk::DependencyInfo{ .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &mipReady });
+        }
+
+        mipWidth = std::max(mipWidth / 2, 1u);
+        mipHeight = std::max(mipHeight / 2, 1u);
+    }
+}
+
+void DepthPyramid::recordCull(const vk::raii::CommandBuffer& commandBuffer,
+                              DescriptorAllocator& descriptors,
+                              vk::Buffer boundsBuffer,
+                              vk::Buffer visibilityBuffer,
+                              const CullParams& params) {
+
+    if (!_cullingAvailable || params.objectCount == 0)
+        return;
+
+    //The last downsample write has no trailing barrier - cover the whole pyramid read here
+    vk::ImageMemoryBarrier2 pyramidReady{
+        .srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+        .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+        .dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead,
+        .oldLayout = vk::ImageLayout::eGeneral,
+        .newLayout = vk::ImageLayout::eGeneral,
+        .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+        .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+        .image = _pyramidImage,
+        .subresourceRange = { .aspectMask = vk::ImageAspectFlagBits::eColor,
+                              .baseMipLevel = 0, .levelCount = _mipCount, .baseArrayLayer = 0, .layerCount = 1 } };
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo{ .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &pyramidReady });
+
+    vk::DescriptorImageInfo pyramidInfo{
+        .sampler = _pointSampler,
+        .imageView = _pyramidFullView,
+        .imageLayout = vk::ImageLayout::eGeneral };
+    vk::DescriptorBufferInfo boundsInfo{ .buffer = boundsBuffer, .range = vk::WholeSize };
+    vk::DescriptorBufferInfo visibilityInfo{ .buffer = visibilityBuffer, .range = vk::WholeSize };
+
+    const vk::DescriptorSet set = descriptors.allocateTransient(_cullSetLayout);
+    const std::array writes = {
+        vk::WriteDescriptorSet{ .dstSet = set, .dstBinding = 0, .descriptorCount = 1,
+                                .descriptorType = vk::DescriptorType::eCombinedImageSampler, .pImageInfo = &pyramidInfo },
+        vk::WriteDescriptorSet{ .dstSet = set, .dstBinding = 1, .descriptorCount = 1,
+                                .descriptorType = vk::DescriptorType::eStorageBuffer, .pBufferInfo = &boundsInfo },
+        vk::WriteDescriptorSet{ .dstSet = set, .dstBinding = 2, .descriptorCount = 1,
+                                .descriptorType = vk::DescriptorType::eStorageBuffer, .pBufferInfo = &visibilityInfo } };
+    _device->updateDescriptorSets(writes, nullptr);
+
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, _cullPipeline);
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, _cullLayout, 0, { set }, {});
+
+    CullParams push = params;
+    push.mipCount = _mipCount;
+    commandBuffer.pushConstants<CullParams>(_cullLayout, vk::ShaderStageFlagBits::eCompute, 0, push);
+    commandBuffer.dispatch(groupCount(params.objectCount, 64), 1, 1);
+
+    //Visibility results feed indirect-command generation (compute) and indirect draws
+    vk::BufferMemoryBarrier2 visibilityReady{
+        .srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+        .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eDrawIndirect,
+        .dstAccessMask = vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eIndirectCommandRead,
+        .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+        .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+        .buffer = visibilityBuffer,
+        .size = vk::WholeSize };
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo{ .bufferMemoryBarrierCount = 1, .pBufferMemoryBarriers = &visibilityReady });
+}
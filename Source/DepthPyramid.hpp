@@ -0,0 +1,116 @@
+#pragma once
+
+#include "VulkanCommon.hpp"
+#include "GpuAllocator.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class ShaderCache;
+class PipelineCacheStore;
+class DescriptorAllocator;
+
+/*
+Depth target plus hierarchical-Z occlusion culling. The depth image is sized to
+the swapchain extent and recreated with it; next to it lives a full-mip R32F
+pyramid where every texel of mip N holds the FARTHEST depth of the 2x2 texels
+below it. A draw whose bounds are nearer than the pyramid says anything at that
+screen location can be is potentially visible; everything else is occluded and
+recordCull() writes a 0 into its visibility slot. Interior-heavy scenes lose the
+bulk of their overdraw to this one pass.
+
+The downsample and cull run as compute (Shaders/*.comp, compiled offline to
+.spv next to the sources); when the bytecode is missing the depth target still
+works and cullingAvailable() reports false, so rendering degrades to
+no-occlusion rather than failing. On non-power-of-two levels the 2x2 reduction
+also folds in the otherwise-dropped odd row/column: skipping it would let the
+stored max miss the true farthest depth and wrongly cull objects visible
+through those texels.
+*/
+class DepthPyramid {
+public:
+
+    //World-space AABB per object; the shader projects the corners itself
+    struct ObjectBounds {
+        float center[4];  //w unused
+        float extents[4]; //half-size, w unused
+    };
+
+    struct CullParams {
+        float viewProj[16] = {};
+        uint32_t objectCount = 0;
+        uint32_t mipCount = 0;
+    };
+
+    void init(const vk::raii::Device& device,
+              const vk::raii::PhysicalDevice& physicalDevice,
+              GpuAllocator& allocator,
+              ShaderCache& shaderCache,
+              PipelineCacheStore& pipelineCacheStore);
+
+    //(Re)creates the depth image and pyramid for the extent; call alongside swapchain creation
+    void create(vk::Extent2D extent);
+
+    vk::Format depthFormat() const { return _depthFormat; }
+    vk::ImageView depthView() const { return _depthView; }
+    bool cullingAvailable() const { return _cullingAvailable; }
+
+    //Transitions the depth image and clears it to far; stand-in for the geometry prepass
+    void recordClear(const vk::raii::CommandBuffer& commandBuffer);
+
+    /*Rebuilds the whole pyramid from the depth image. depthCurrentLayout is whatever
+      the preceding pass left the depth image in (eTransferDstOptimal after
+      recordClear, eDepthStencilAttachmentOptimal after a real depth pass).*/
+    void recordDownsample(const vk::raii::CommandBuffer& commandBuffer,
+                          DescriptorAllocator& descriptors,
+                          vk::ImageLayout depthCurrentLayout);
+
+    /*Tests objectCount bounds against the pyramid and writes 1/0 per object into
+      visibilityBuffer (uint per object). Leaves the visibility writes visible to
+      compute and indirect-draw consumers.*/
+    void recordCull(const vk::raii::CommandBuffer& commandBuffer,
+                    DescriptorAllocator& descriptors,
+                    vk::Buffer boundsBuffer,
+                    vk::Buffer visibilityBuffer,
+                    const CullParams& params);
+
+private:
+
+    struct DownsamplePush {
+        uint32_t dstWidth = 0;
+        uint32_t dstHeight = 0;
+        uint32_t firstPass = 0; //1 = straight copy from the depth image, 0 = 2x2 max reduce
+    };
+
+    static vk::Format pickDepthFormat(const vk::raii::PhysicalDevice& physicalDevice);
+    void createPipelines();
+    void releaseTargets();
+
+    const vk::raii::Device* _device = nullptr;
+    GpuAllocator* _allocator = nullptr;
+    ShaderCache* _shaderCache = nullptr;
+    PipelineCacheStore* _pipelineCacheStore = nullptr;
+
+    vk::Format _depthFormat = vk::Format::eUndefined;
+    vk::Extent2D _extent;
+    uint32_t _mipCount = 0;
+
+    vk::raii::Image _depthImage = nullptr;
+    GpuAllocator::Allocation _depthAllocation;
+    vk::raii::ImageView _depthView = nullptr;
+
+    vk::raii::Image _pyramidImage = nullptr;
+    GpuAllocator::Allocation _pyramidAllocation;
+    vk::raii::ImageView _pyramidFullView = nullptr;        //all mips, for the cull pass
+    std::vector<vk::raii::ImageView> _pyramidMipViews;     //one mip each, for the downsample chain
+
+    vk::raii::Sampler _pointSampler = nullptr;
+
+    bool _cullingAvailable = false;
+    vk::raii::DescriptorSetLayout _downsampleSetLayout = nullptr;
+    vk::raii::PipelineLayout _downsampleLayout = nullptr;
+    vk::raii::Pipeline _downsamplePipeline = nullptr;
+    vk::raii::DescriptorSetLayout _cullSetLayout = nullptr;
+    vk::raii::PipelineLayout _cullLayout = nullptr;
+    vk::raii::Pipeline _cullPipeline = nullptr;
+};
@@ -0,0 +1,88 @@
+#include "DescriptorAllocator.hpp"
+
+#include <array>
+
+void DescriptorAllocator::init(const vk::raii::Device& device, uint32_t frameCount) {
+    _device = &device;
+    _transient.resize(frameCount);
+}
+
+vk::raii::DescriptorPool DescriptorAllocator::createPool() const {
+
+    /*Ratios sized from observed usage in comparable scenes: lots of sampled images,
+      a uniform buffer or two per set, storage buffers for the GPU-driven paths.
+      Getting them wrong only means arenas grow an extra pool sooner.*/
+    static constexpr std::array poolSizes = {
+        vk::DescriptorPoolSize{ .type = vk::DescriptorType::eCombinedImageSampler, .descriptorCount = 2048 },
+        vk::DescriptorPoolSize{ .type = vk::DescriptorType::eUniformBuffer,        .descriptorCount = 1024 },
+        vk::DescriptorPoolSize{ .type = vk::DescriptorType::eStorageBuffer,        .descriptorCount = 512 },
+        vk::DescriptorPoolSize{ .type = vk::DescriptorType::eUniformBufferDynamic, .descriptorCount = 256 },
+        vk::DescriptorPoolSize{ .type = vk::DescriptorType::eStorageImage,         .descriptorCount = 256 },
+        vk::DescriptorPoolSize{ .type = vk::DescriptorType::eSampler,              .descriptorCount = 128 },
+    };
+
+    //No eFreeDescriptorSet: sets are reclaimed by pool reset or pool destruction only,
+    //which lets the driver use a cheap linear allocator internally
+    return vk::raii::DescriptorPool(*_device, vk::DescriptorPoolCreateInfo{
+        .maxSets = 1024,
+        .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+        .pPoolSizes = poolSizes.data() });
+}
+
+vk::DescriptorSet DescriptorAllocator::allocateFrom(PoolArena& arena, vk::DescriptorSetLayout layout) {
+
+    if (arena.pools.empty())
+        arena.pools.push_back(createPool());
+
+    while (true)
+    {
+        vk::DescriptorSetAllocateInfo allocateInfo{ .descriptorPool = arena.pools[arena.activePool],
+                                                    .descriptorSetCount = 1,
+                                                    .pSetLayouts = &layout };
+        try
+        {
+            //Non-raii allocation on purpose: arena sets are reclaimed wholesale by pool
+            //reset, never freed individually
+            return vk::Device(**_device).allocateDescriptorSets(allocateInfo).front();
+        }
+        catch (const vk::OutOfPoolMemoryError&)
+        {
+        }
+        catch (const vk::FragmentedPoolError&)
+        {
+        }
+
+        //Active pool is full - move to the next one, growing the arena if needed
+        arena.activePool++;
+        if (arena.activePool == arena.pools.size())
+            arena.pools.push_back(createPool());
+    }
+}
+
+vk::DescriptorSet DescriptorAllocator::allocate(vk::DescriptorSetLayout layout) {
+    return allocateFrom(_persistent, layout);
+}
+
+void DescriptorAllocator::beginFrame(uint32_t frameSlot) {
+
+    _currentSlot = frameSlot;
+    PoolArena& arena = _transient[frameSlot];
+    for (auto& pool : arena.pools)
+        pool.reset(); //O(1) reclaim of every set allocated last time around the ring
+    arena.activePool = 0;
+}
+
+vk::DescriptorSet DescriptorAllocator::allocateTransient(vk::DescriptorSetLayout layout) {
+    return allocateFrom(_transient[_currentSlot], layout);
+}
+
+vk::raii::DescriptorUpdateTemplate DescriptorAllocator::createUpdateTemplate(
+    vk::DescriptorSetLayout layout,
+    std::span<const vk::DescriptorUpdateTemplateEntry> entries) const {
+
+    return vk::raii::DescriptorUpdateTemplate(*_device, vk::DescriptorUpdateTemplateCreateInfo{
+        .descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size()),
+        .pDescriptorUpdateEntries = entries.data(),
+        .templateType = vk::DescriptorUpdateTemplateType::eDescriptorSet,
+        .descriptorSetLayout = layout });
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "VulkanCommon.hpp"
+
+#include <span>
+#include <vector>
+
+/*
+Descriptor set management. Individual vkAllocateDescriptorSets/vkFreeDescriptorSets
+calls add up to a measurable slice of frame CPU time on descriptor-heavy scenes, so
+sets are never freed one by one here:
+
+ - persistent sets come from a growable arena of pools (a new pool is added when the
+   active one runs dry) and live until the allocator does;
+ - transient sets come from per-frame-slot arenas that reset whole pools in O(1) at
+   beginFrame(), which is safe because the frame engine already waited for the slot.
+
+For the hot per-draw update path, createUpdateTemplate()/updateWithTemplate() wrap
+vk::DescriptorUpdateTemplate so a set is written from one packed struct instead of
+N vkUpdateDescriptorSets calls.
+
+Not internally synchronized: allocate from one thread, or give each recording
+thread its own allocator.
+*/
+class DescriptorAllocator {
+public:
+
+    void init(const vk::raii::Device& device, uint32_t frameCount);
+
+    //Persistent set - valid until the allocator is destroyed
+    vk::DescriptorSet allocate(vk::DescriptorSetLayout layout);
+
+    //Resets the slot's transient pools in O(1); call once per frame before allocateTransient
+    void beginFrame(uint32_t frameSlot);
+
+    //Transient set - valid only until this slot's next beginFrame
+    vk::DescriptorSet allocateTransient(vk::DescriptorSetLayout layout);
+
+    vk::raii::DescriptorUpdateTemplate createUpdateTemplate(vk::DescriptorSetLayout layout,
+                                                            std::span<const vk::DescriptorUpdateTemplateEntry> entries) const;
+
+    template <typename DataType>
+    void updateWithTemplate(vk::DescriptorSet set,
+                            const vk::raii::DescriptorUpdateTemplate& updateTemplate,
+                            const DataType& data) const {
+        vk::Device(**_device).updateDescriptorSetWithTemplate(set, updateTemplate, data);
+    }
+
+private:
+
+    struct PoolArena {
+        std::vector<vk::raii::DescriptorPool> pools;
+        size_t activePool = 0;
+    };
+
+    vk::raii::DescriptorPool createPool() const;
+    vk::DescriptorSet allocateFrom(PoolArena& arena, vk::DescriptorSetLayout layout);
+
+    const vk::raii::Device* _device = nullptr;
+    PoolArena _persistent;
+    std::vector<PoolArena> _transient; //one arena per frame slot
+    uint32_t _currentSlot = 0;
+};
@@ -0,0 +1,24 @@
+#include "FrameArena.hpp"
+
+#include <stdexcept>
+
+void FrameArena::init(size_t capacity) {
+    _storage.resize(capacity);
+    _used.store(0, std::memory_order_relaxed);
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment) {
+
+    //Same lock-free bump the job system's payload arena uses
+    size_t offset = _used.load(std::memory_order_relaxed);
+    size_t aligned, next;
+    do
+    {
+        aligned = (offset + alignment - 1) & ~(alignment - 1);
+        next = aligned + size;
+        if (next > _storage.size())
+            throw std::runtime_error("frame arena exhausted - raise the init() capacity");
+    } while (!_used.compare_exchange_weak(offset, next, std::memory_order_relaxed));
+
+    return _storage.data() + aligned;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+
+/*
+CPU-side linear allocator for per-frame scratch data: submit-info arrays,
+barrier lists, streaming batches - anything built during a frame and dead by
+the next one. Allocation is an atomic bump (safe from job workers), reset() at
+frame start is O(1), and nothing is ever freed individually, so the frame loop
+never touches malloc: on comparable engines that churn is 3-5% of CPU time and
+the main source of tail-latency spikes under allocator lock contention.
+
+FrameAllocator<T> is the STL adapter; FrameVector<T> is the common case:
+
+    FrameVector<vk::ImageMemoryBarrier2> barriers(FrameAllocator<vk::ImageMemoryBarrier2>(_frameArena));
+
+Deallocation is a no-op by design - capacity comes back only at reset(). Keep
+anything that must outlive the frame out of the arena.
+*/
+class FrameArena {
+public:
+
+    void init(size_t capacity = 4 * 1024 * 1024);
+
+    //Frees everything allocated since the last reset, in O(1)
+    void reset() { _used.store(0, std::memory_order_relaxed); }
+
+    //Throws when the frame outgrows the arena; raise the init() capacity, do not fall back to malloc silently
+    void* allocate(size_t size, size_t alignment);
+
+    size_t used() const { return _used.load(std::memory_order_relaxed); }
+    size_t capacity() const { return _storage.size(); }
+
+private:
+
+    std::vector<std::byte> _storage;
+    std::atomic<size_t> _used{ 0 };
+};
+
+template <typename T>
+class FrameAllocator {
+public:
+
+    using value_type = T;
+
+    explicit FrameAllocator(FrameArena& arena) : _arena(&arena) {}
+
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>& other) : _arena(other._arena) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(_arena->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {
+        //intentionally nothing: the memory returns at FrameArena::reset()
+    }
+
+    template <typename U>
+    bool operator==(const FrameAllocator<U>& other) const { return _arena == other._arena; }
+
+    FrameArena* _arena;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
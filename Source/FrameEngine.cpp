@@ -0,0 +1,120 @@
+#include "FrameEngine.hpp"
+
+void FrameEngine::init(const vk::raii::Device& device, uint32_t graphicsQueueFamilyIndex) {
+
+    vk::SemaphoreTypeCreateInfo timelineTypeInfo{ .semaphoreType = vk::SemaphoreType::eTimeline, .initialValue = 0 };
+    _timelineSemaphore = vk::raii::Semaphore(device, vk::SemaphoreCreateInfo{ .pNext = &timelineTypeInfo });
+
+    _frames.clear();
+    for (uint32_t frameIndex = 0; frameIndex < MaxFramesInFlight; frameIndex++)
+    {
+        Frame frame;
+        frame.commandPool = vk::raii::CommandPool(device, vk::CommandPoolCreateInfo{ .queueFamilyIndex = graphicsQueueFamilyIndex });
+
+        vk::CommandBufferAllocateInfo allocateInfo{ .commandPool = frame.commandPool,
+                                                    .level = vk::CommandBufferLevel::ePrimary,
+                                                    .commandBufferCount = 1 };
+        frame.commandBuffer = std::move(vk::raii::CommandBuffers(device, allocateInfo).front());
+        _frames.push_back(std::move(frame));
+    }
+}
+
+FrameEngine::Frame& FrameEngine::beginFrame(const vk::raii::Device& device) {
+
+    Frame& frame = _frames[_currentFrame];
+
+    //Wait until the GPU has consumed whatever this slot submitted last time around the ring.
+    //The first MaxFramesInFlight frames have nothing to wait for.
+    if (frame.timelineValue != 0)
+    {
+        vk::Semaphore timelineSemaphore = _timelineSemaphore;
+        vk::SemaphoreWaitInfo waitInfo{ .semaphoreCount = 1,
+                                        .pSemaphores = &timelineSemaphore,
+                                        .pValues = &frame.timelineValue };
+        while (device.waitSemaphores(waitInfo, UINT64_MAX) == vk::Result::eTimeout)
+            ;
+    }
+
+    frame.commandPool.reset();
+    frame.commandBuffer.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    return frame;
+}
+
+void FrameEngine::waitForSubmitted(const vk::raii::Device& device) const {
+
+    if (_frameNumber == 0)
+        return;
+
+    vk::Semaphore timelineSemaphore = _timelineSemaphore;
+    vk::SemaphoreWaitInfo waitInfo{ .semaphoreCount = 1,
+                                    .pSemaphores = &timelineSemaphore,
+                                    .pValues = &_frameNumber };
+    while (device.waitSemaphores(waitInfo, UINT64_MAX) == vk::Result::eTimeout)
+        ;
+}
+
+void FrameEngine::submitFrame(const vk::raii::Queue& queue,
+                              std::span<const vk::Semaphore> acquireSemaphores,
+                              std::span<const vk::Semaphore> renderFinishedSemaphores,
+                              std::span<const vk::SemaphoreSubmitInfo> extraWaits) {
+
+    Frame& frame = _frames[_currentFrame];
+    frame.commandBuffer.end();
+
+    _frameNumber++;
+    frame.timelineValue = _frameNumber;
+
+    //Rendering must not start writing a swapchain image before its acquisition signals it free.
+    std::vector<vk::SemaphoreSubmitInfo> waitInfos;
+    waitInfos.reserve(acquireSemaphores.size() + extraWaits.size());
+    for (const vk::Semaphore acquireSemaphore : acquireSemaphores)
+        waitInfos.push_back(vk::SemaphoreSubmitInfo{ .semaphore = acquireSemaphore,
+                                                     .stageMask = vk::PipelineStageFlagBits2::eColorAttachmentOutput });
+    waitInfos.insert(waitInfos.end(), extraWaits.begin(), extraWaits.end());
+
+    vk::CommandBufferSubmitInfo commandBufferInfo{ .commandBuffer = frame.commandBuffer };
+
+    //One signal per presented window, one bumping the timeline so the slot can be recycled.
+    std::vector<vk::SemaphoreSubmitInfo> signalInfos;
+    signalInfos.reserve(renderFinishedSemaphores.size() + 1);
+    for (const vk::Semaphore renderFinishedSemaphore : renderFinishedSemaphores)
+        signalInfos.push_back(vk::SemaphoreSubmitInfo{ .semaphore = renderFinishedSemaphore,
+                                                       .stageMask = vk::PipelineStageFlagBits2::eAllCommands });
+    signalInfos.push_back(vk::SemaphoreSubmitInfo{ .semaphore = _timelineSemaphore,
+                                                   .value = frame.timelineValue,
+                                                   .stageMask = vk::PipelineStageFlagBits2::eAllCommands });
+
+    vk::SubmitInfo2 submitInfo{ .waitSemaphoreInfoCount = static_cast<uint32_t>(waitInfos.size()),
+                                .pWaitSemaphoreInfos = waitInfos.data(),
+                                .commandBufferInfoCount = 1,
+                                .pCommandBufferInfos = &commandBufferInfo,
+                                .signalSemaphoreInfoCount = static_cast<uint32_t>(signalInfos.size()),
+                                .pSignalSemaphoreInfos = signalInfos.data() };
+    queue.submit2(submitInfo);
+
+    _currentFrame = (_currentFrame + 1) % MaxFramesInFlight;
+}
+
+void FrameEngine::submitFrame(const vk::raii::Queue& queue,
+                              std::span<const vk::SemaphoreSubmitInfo> extraWaits) {
+
+    Frame& frame = _frames[_currentFrame];
+    frame.commandBuffer.end();
+
+    _frameNumber++;
+    frame.timelineValue = _frameNumber;
+
+    vk::CommandBufferSubmitInfo commandBufferInfo{ .commandBuffer = frame.commandBuffer };
+    vk::SemaphoreSubmitInfo signalInfo{ .semaphore = _timelineSemaphore,
+                                        .value = frame.timelineValue,
+                                        .stageMask = vk::PipelineStageFlagBits2::eAllCommands };
+
+    queue.submit2(vk::SubmitInfo2{ .waitSemaphoreInfoCount = static_cast<uint32_t>(extraWaits.size()),
+                                   .pWaitSemaphoreInfos = extraWaits.data(),
+                                   .commandBufferInfoCount = 1,
+                                   .pCommandBufferInfos = &commandBufferInfo,
+                                   .signalSemaphoreInfoCount = 1,
+                                   .pSignalSemaphoreInfos = &signalInfo });
+
+    _currentFrame = (_currentFrame + 1) % MaxFramesInFlight;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "VulkanCommon.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/*
+Ring of per-frame resources so the CPU can record frame N+1 while the GPU is still
+consuming frame N. Each slot owns its own command pool (resetting a whole pool is
+cheaper than resetting individual buffers). Acquire semaphores live with the
+window surfaces that acquire - with several windows each swapchain acquires
+independently, and the submit simply waits on all of them.
+
+GPU completion is tracked with a single timeline semaphore instead of one fence per
+frame: a slot stores the timeline value it signalled on submit, and reusing the slot
+just waits until the timeline has reached that value.
+*/
+class FrameEngine {
+public:
+
+    //Two frames in flight: the CPU records one frame ahead of the GPU.
+    //More frames add input latency without improving GPU occupancy.
+    static constexpr uint32_t MaxFramesInFlight = 2;
+
+    struct Frame {
+        vk::raii::CommandPool commandPool = nullptr;
+        vk::raii::CommandBuffer commandBuffer = nullptr;
+        uint64_t timelineValue = 0; //timeline value this slot signalled on its last submit, 0 = never submitted
+    };
+
+    void init(const vk::raii::Device& device, uint32_t graphicsQueueFamilyIndex);
+
+    /*Blocks until the GPU has finished the work this slot submitted MaxFramesInFlight
+      frames ago, then resets the slot's command pool and begins its command buffer.*/
+    Frame& beginFrame(const vk::raii::Device& device);
+
+    /*Ends the current command buffer and submits it, waiting on every given acquire
+      semaphore and signalling every given present semaphore plus the timeline value
+      used to recycle the slot later. One entry per window that acquired this frame.
+      extraWaits carries cross-queue dependencies (e.g. the upload timeline) verbatim.*/
+    void submitFrame(const vk::raii::Queue& queue,
+                     std::span<const vk::Semaphore> acquireSemaphores,
+                     std::span<const vk::Semaphore> renderFinishedSemaphores,
+                     std::span<const vk::SemaphoreSubmitInfo> extraWaits = {});
+
+    //Headless variant: no swapchain to synchronize with, so the submit carries only
+    //the extra waits and the timeline signal used for slot recycling
+    void submitFrame(const vk::raii::Queue& queue,
+                     std::span<const vk::SemaphoreSubmitInfo> extraWaits = {});
+
+    /*Blocks until every frame submitted so far has finished on the GPU. A targeted
+      alternative to deviceWaitIdle: other queues (e.g. transfer) keep running.*/
+    void waitForSubmitted(const vk::raii::Device& device) const;
+
+    uint64_t frameNumber() const { return _frameNumber; }
+
+    //Index of the slot currently being recorded, for subsystems that keep their own per-frame rings
+    uint32_t currentFrameSlot() const { return _currentFrame; }
+
+private:
+
+    std::vector<Frame> _frames;
+    vk::raii::Semaphore _timelineSemaphore = nullptr;
+    uint64_t _frameNumber = 0; //monotonically increasing, doubles as the timeline signal value
+    uint32_t _currentFrame = 0;
+};
@@ -0,0 +1,93 @@
+#include "FrameStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void FrameStats::init(const std::filesystem::path& outputFile, double hitchThresholdMs) {
+    _output.open(outputFile, std::ios::app); //append: one file accumulates across runs for the dashboard
+    _hitchThresholdMs = hitchThresholdMs;
+    _frameTimesMs.reserve(WindowSize);
+}
+
+void FrameStats::appendRecord(const nlohmann::json& record) {
+    if (_output)
+        _output << record.dump() << '\n' << std::flush;
+}
+
+void FrameStats::recordFrame(const nlohmann::json& gpuTimings) {
+
+    const auto now = std::chrono::steady_clock::now();
+    if (!_hasLastFrame)
+    {
+        _lastFrameEnd = now;
+        _hasLastFrame = true;
+        return;
+    }
+
+    const double frameTimeMs = std::chrono::duration<double, std::milli>(now - _lastFrameEnd).count();
+    _lastFrameEnd = now;
+    _frameCount++;
+
+    //Rolling window for the percentile math
+    if (_frameTimesMs.size() < WindowSize)
+        _frameTimesMs.push_back(frameTimeMs);
+    else
+        _frameTimesMs[_nextSlot] = frameTimeMs;
+    _nextSlot = (_nextSlot + 1) % WindowSize;
+
+    _histogram[std::min<size_t>(static_cast<size_t>(frameTimeMs / 2.0), HistogramBuckets - 1)]++;
+
+    //Jitter: how unevenly frames land, independent of how long they take on average
+    const double delta = std::abs(frameTimeMs - _lastFrameTimeMs);
+    _jitterMsEma = (_jitterMsEma == 0.0) ? delta : (_jitterMsEma * 0.95 + delta * 0.05);
+    _lastFrameTimeMs = frameTimeMs;
+
+    /*Hitch: snapshot everything we know about this frame. The GPU scopes answer the
+      first escalation question - was it CPU recording or GPU execution.*/
+    if (frameTimeMs > _hitchThresholdMs)
+    {
+        appendRecord({ {"type", "hitch"},
+                       {"frame", _frameCount},
+                       {"ms", frameTimeMs},
+                       {"gpu", gpuTimings} });
+    }
+
+    if (_frameCount % SummaryInterval == 0)
+    {
+        nlohmann::json record = summary();
+        record["type"] = "summary";
+        record["frame"] = _frameCount;
+        appendRecord(record);
+    }
+}
+
+nlohmann::json FrameStats::summary() const {
+
+    if (_frameTimesMs.empty())
+        return nlohmann::json::object();
+
+    std::vector<double> sorted = _frameTimesMs;
+    std::ranges::sort(sorted);
+
+    auto percentile = [&](double fraction) {
+        const size_t index = std::min(sorted.size() - 1, static_cast<size_t>(fraction * static_cast<double>(sorted.size())));
+        return sorted[index];
+    };
+
+    double sum = 0.0;
+    for (const double value : sorted)
+        sum += value;
+
+    nlohmann::json histogram = nlohmann::json::array();
+    for (size_t bucket = 0; bucket < HistogramBuckets; bucket++)
+    {
+        if (_histogram[bucket] != 0)
+            histogram.push_back({ {"ms", bucket * 2}, {"count", _histogram[bucket]} });
+    }
+
+    return { {"avgMs", sum / static_cast<double>(sorted.size())},
+             {"p99Ms", percentile(0.99)},   //the "1% lows"
+             {"p999Ms", percentile(0.999)}, //the "0.1% lows"
+             {"jitterMs", _jitterMsEma},
+             {"histogram", histogram} };
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+/*
+Frame-time telemetry for the fleet dashboard. Tracks a rolling window of frame
+times for 1% / 0.1% lows, a histogram, and frame-to-frame jitter (measured at
+submit time on the CPU clock - VK_EXT_present_timing hardware timestamps can
+replace this where drivers grow support). A hitch detector appends a
+newline-delimited JSON record - including the GPU profiler scopes of the guilty
+frame - whenever a frame blows past the threshold, and a rolling summary record
+goes out periodically so regressions across driver updates show up without
+anyone watching a screen.
+*/
+class FrameStats {
+public:
+
+    static constexpr size_t WindowSize = 1000;      //frames in the percentile window
+    static constexpr size_t SummaryInterval = 600;  //frames between summary records
+
+    void init(const std::filesystem::path& outputFile, double hitchThresholdMs = 33.0);
+
+    //Once per frame, right after the frame is submitted/presented.
+    //gpuTimings: GpuProfiler::report() of the most recently harvested frame.
+    void recordFrame(const nlohmann::json& gpuTimings);
+
+    //Rolling statistics: average, p99/p99.9 (the 1% and 0.1% lows), jitter, histogram
+    nlohmann::json summary() const;
+
+private:
+
+    void appendRecord(const nlohmann::json& record);
+
+    std::ofstream _output;
+    double _hitchThresholdMs = 33.0;
+
+    std::vector<double> _frameTimesMs; //ring of the last WindowSize frame times
+    size_t _nextSlot = 0;
+    uint64_t _frameCount = 0;
+    double _lastFrameTimeMs = 0.0;
+    double _jitterMsEma = 0.0; //exponential moving average of |delta - previous delta|
+
+    //2 ms buckets up to 100 ms, last bucket catches the rest
+    static constexpr size_t HistogramBuckets = 51;
+    std::array<uint64_t, HistogramBuckets> _histogram{};
+
+    std::chrono::steady_clock::time_point _lastFrameEnd{};
+    bool _hasLastFrame = false;
+};
@@ -0,0 +1,194 @@
+#include "GpuAllocator.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+void GpuAllocator::init(const vk::raii::Device& device,
+                        const vk::raii::PhysicalDevice& physicalDevice,
+                        vk::DeviceSize blockSize) {
+    _device = &device;
+    _physicalDevice = &physicalDevice;
+    _blockSize = blockSize;
+}
+
+uint32_t GpuAllocator::findMemoryType(uint32_t typeBits, vk::MemoryPropertyFlags properties) const {
+
+    const auto memoryProperties = _physicalDevice->getMemoryProperties();
+    for (uint32_t type = 0; type < memoryProperties.memoryTypeCount; type++)
+    {
+        const bool allowed = (typeBits & (1u << type)) != 0;
+        if (allowed && (memoryProperties.memoryTypes[type].propertyFlags & properties) == properties)
+            return type;
+    }
+    throw std::runtime_error("failed to find a suitable memory type!");
+}
+
+GpuAllocator::Allocation GpuAllocator::allocate(const vk::MemoryRequirements& requirements,
+                                                vk::MemoryPropertyFlags properties) {
+    std::lock_guard lock(_mutex);
+
+    const uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+    const bool hostVisible = (properties & vk::MemoryPropertyFlagBits::eHostVisible) == vk::MemoryPropertyFlagBits::eHostVisible;
+
+    if (requirements.size > _blockSize / 2)
+        return allocateDedicated(requirements, memoryType, hostVisible);
+
+    uint32_t blockIndex = 0;
+    Block& block = findOrCreateBlockWithSpace(memoryType, requirements, hostVisible, blockIndex);
+
+    //First-fit: take the first free range that still fits after alignment
+    for (size_t rangeIndex = 0; rangeIndex < block.freeRanges.size(); rangeIndex++)
+    {
+        FreeRange range = block.freeRanges[rangeIndex];
+        const vk::DeviceSize alignedOffset = alignUp(range.offset, requirements.alignment);
+        if (alignedOffset + requirements.size > range.offset + range.size)
+            continue;
+
+        //Carve the aligned sub-range out; alignment padding and the tail stay free
+        block.freeRanges.erase(block.freeRanges.begin() + rangeIndex);
+        if (alignedOffset > range.offset)
+            block.freeRanges.insert(block.freeRanges.begin() + rangeIndex++,
+                                    FreeRange{ .offset = range.offset, .size = alignedOffset - range.offset });
+        const vk::DeviceSize tailOffset = alignedOffset + requirements.size;
+        const vk::DeviceSize tailSize = (range.offset + range.size) - tailOffset;
+        if (tailSize > 0)
+            block.freeRanges.insert(block.freeRanges.begin() + rangeIndex,
+                                    FreeRange{ .offset = tailOffset, .size = tailSize });
+
+        _usedBytes += requirements.size;
+        return Allocation{ .memory = block.memory,
+                           .offset = alignedOffset,
+                           .size = requirements.size,
+                           .mapped = block.mapped ? static_cast<uint8_t*>(block.mapped) + alignedOffset : nullptr,
+                           .memoryType = memoryType,
+                           .blockIndex = blockIndex,
+                           .dedicated = false };
+    }
+
+    //findOrCreateBlockWithSpace guaranteed a fitting range
+    throw std::runtime_error("GpuAllocator free-list bookkeeping is inconsistent!");
+}
+
+GpuAllocator::Block& GpuAllocator::findOrCreateBlockWithSpace(uint32_t memoryType,
+                                                              const vk::MemoryRequirements& requirements,
+                                                              bool hostVisible,
+                                                              uint32_t& blockIndex) {
+    auto& blocks = _blocksPerType[memoryType];
+    for (uint32_t index = 0; index < blocks.size(); index++)
+    {
+        for (const FreeRange& range : blocks[index].freeRanges)
+        {
+            if (alignUp(range.offset, requirements.alignment) + requirements.size <= range.offset + range.size)
+            {
+                blockIndex = index;
+                return blocks[index];
+            }
+        }
+    }
+
+    //No room anywhere: claim a new block from the driver
+    Block block;
+    block.size = _blockSize;
+    block.memory = vk::raii::DeviceMemory(*_device, vk::MemoryAllocateInfo{ .allocationSize = block.size,
+                                                                            .memoryTypeIndex = memoryType });
+    if (hostVisible)
+        block.mapped = block.memory.mapMemory(0, block.size);
+    block.freeRanges.push_back(FreeRange{ .offset = 0, .size = block.size });
+
+    blocks.push_back(std::move(block));
+    blockIndex = static_cast<uint32_t>(blocks.size() - 1);
+    return blocks.back();
+}
+
+GpuAllocator::Allocation GpuAllocator::allocateDedicated(const vk::MemoryRequirements& requirements,
+                                                         uint32_t memoryType,
+                                                         bool hostVisible) {
+    Block block;
+    block.size = requirements.size;
+    block.memory = vk::raii::DeviceMemory(*_device, vk::MemoryAllocateInfo{ .allocationSize = block.size,
+                                                                            .memoryTypeIndex = memoryType });
+    if (hostVisible)
+        block.mapped = block.memory.mapMemory(0, block.size);
+
+    //Reuse a freed slot so indices stored in live Allocations stay valid
+    uint32_t slot = 0;
+    while (slot < _dedicated.size() && static_cast<bool>(*_dedicated[slot].memory))
+        slot++;
+    if (slot == _dedicated.size())
+        _dedicated.emplace_back();
+    _dedicated[slot] = std::move(block);
+
+    _usedBytes += requirements.size;
+    return Allocation{ .memory = _dedicated[slot].memory,
+                       .offset = 0,
+                       .size = requirements.size,
+                       .mapped = _dedicated[slot].mapped,
+                       .memoryType = memoryType,
+                       .blockIndex = slot,
+                       .dedicated = true };
+}
+
+void GpuAllocator::free(const Allocation& allocation) {
+
+    std::lock_guard lock(_mutex);
+    _usedBytes -= allocation.size;
+
+    if (allocation.dedicated)
+    {
+        _dedicated[allocation.blockIndex] = Block{}; //releases the vk::raii::DeviceMemory, keeps the slot
+        return;
+    }
+
+    auto& freeRanges = _blocksPerType[allocation.memoryType][allocation.blockIndex].freeRanges;
+
+    //Insert sorted by offset, then merge with the neighbours if they touch
+    auto insertPos = std::ranges::lower_bound(freeRanges, allocation.offset, {}, &FreeRange::offset);
+    insertPos = freeRanges.insert(insertPos, FreeRange{ .offset = allocation.offset, .size = allocation.size });
+
+    if (auto next = insertPos + 1; next != freeRanges.end() && insertPos->offset + insertPos->size == next->offset)
+    {
+        insertPos->size += next->size;
+        freeRanges.erase(next);
+    }
+    if (insertPos != freeRanges.begin())
+    {
+        auto prev = insertPos - 1;
+        if (prev->offset + prev->size == insertPos->offset)
+        {
+            prev->size += insertPos->size;
+            freeRanges.erase(insertPos);
+        }
+    }
+}
+
+GpuAllocator::Stats GpuAllocator::stats() const {
+
+    std::lock_guard lock(_mutex);
+    Stats stats;
+    stats.usedBytes = _usedBytes;
+
+    for (const auto& blocks : _blocksPerType)
+    {
+        for (const Block& block : blocks)
+        {
+            stats.blockCount++;
+            stats.allocatedBytes += block.size;
+            stats.freeRangeCount += static_cast<uint32_t>(block.freeRanges.size());
+        }
+    }
+    for (const Block& block : _dedicated)
+    {
+        if (static_cast<bool>(*block.memory))
+        {
+            stats.dedicatedCount++;
+            stats.allocatedBytes += block.size;
+        }
+    }
+    return stats;
+}
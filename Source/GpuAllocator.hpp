@@ -0,0 +1,85 @@
+#pragma once
+
+#include "VulkanCommon.hpp"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/*
+Pooled GPU memory allocator. Drivers cap the number of live vkAllocateMemory
+allocations (maxMemoryAllocationCount, commonly 4096) and each call costs on the
+order of 100 microseconds, so per-resource allocations do not survive contact with
+real content. Instead we allocate large blocks per memory type and hand out aligned
+sub-ranges from a first-fit free list; freed ranges are merged back with their
+neighbours so blocks do not fragment permanently.
+
+Resources bigger than half a block get a dedicated allocation - splitting them
+across the pool would waste more than it saves. Host-visible blocks are mapped
+once at creation and never unmapped; sub-allocations expose their slice of the
+mapping directly.
+*/
+class GpuAllocator {
+public:
+
+    struct Allocation {
+        vk::DeviceMemory memory;
+        vk::DeviceSize offset = 0;
+        vk::DeviceSize size = 0;
+        void* mapped = nullptr; //points at this sub-range, only for host-visible memory
+
+        //bookkeeping for free()
+        uint32_t memoryType = 0;
+        uint32_t blockIndex = 0;
+        bool dedicated = false;
+    };
+
+    struct Stats {
+        uint32_t blockCount = 0;
+        uint32_t dedicatedCount = 0;
+        vk::DeviceSize allocatedBytes = 0; //total block + dedicated memory claimed from the driver
+        vk::DeviceSize usedBytes = 0;      //bytes handed out to live sub-allocations
+        uint32_t freeRangeCount = 0;       //free-list entries across all blocks, a fragmentation indicator
+    };
+
+    void init(const vk::raii::Device& device,
+              const vk::raii::PhysicalDevice& physicalDevice,
+              vk::DeviceSize blockSize = 128ull * 1024 * 1024);
+
+    Allocation allocate(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties);
+    void free(const Allocation& allocation);
+
+    //Picks a memory type allowed by typeBits that has all the wanted property flags
+    uint32_t findMemoryType(uint32_t typeBits, vk::MemoryPropertyFlags properties) const;
+
+    Stats stats() const;
+
+private:
+
+    struct FreeRange {
+        vk::DeviceSize offset;
+        vk::DeviceSize size;
+    };
+
+    struct Block {
+        vk::raii::DeviceMemory memory = nullptr;
+        vk::DeviceSize size = 0;
+        void* mapped = nullptr;
+        std::vector<FreeRange> freeRanges; //sorted by offset, adjacent ranges merged on free
+    };
+
+    Allocation allocateDedicated(const vk::MemoryRequirements& requirements, uint32_t memoryType, bool hostVisible);
+    Block& findOrCreateBlockWithSpace(uint32_t memoryType, const vk::MemoryRequirements& requirements,
+                                      bool hostVisible, uint32_t& blockIndex);
+
+    const vk::raii::Device* _device = nullptr;
+    const vk::raii::PhysicalDevice* _physicalDevice = nullptr;
+    vk::DeviceSize _blockSize = 0;
+
+    std::array<std::vector<Block>, VK_MAX_MEMORY_TYPES> _blocksPerType;
+    std::vector<Block> _dedicated; //freed entries keep their slot (memory = nullptr) so indices stay stable
+
+    mutable std::mutex _mutex; //uploads, streaming and shader threads all allocate concurrently
+    vk::DeviceSize _usedBytes = 0;
+};
@@ -0,0 +1,90 @@
+#include "GpuProfiler.hpp"
+
+void GpuProfiler::init(const vk::raii::Device& device,
+                       const vk::raii::PhysicalDevice& physicalDevice,
+                       uint32_t graphicsQueueFamilyIndex,
+                       uint32_t frameCount) {
+
+    //Some queues (and some virtual GPUs) expose no timestamp support; degrade to no-ops
+    const auto queueFamilyProperties = physicalDevice.getQueueFamilyProperties();
+    _supported = queueFamilyProperties[graphicsQueueFamilyIndex].timestampValidBits != 0;
+    if (!_supported)
+        return;
+
+    _timestampPeriod = physicalDevice.getProperties().limits.timestampPeriod;
+
+    _frames.clear();
+    for (uint32_t frame = 0; frame < frameCount; frame++)
+    {
+        FrameQueries frameQueries;
+        frameQueries.queryPool = vk::raii::QueryPool(device, vk::QueryPoolCreateInfo{ .queryType = vk::QueryType::eTimestamp,
+                                                                                      .queryCount = MaxScopesPerFrame * 2 });
+        _frames.push_back(std::move(frameQueries));
+    }
+}
+
+void GpuProfiler::beginFrame(uint32_t frameSlot, const vk::raii::CommandBuffer& commandBuffer) {
+
+    if (!_supported)
+        return;
+
+    _currentSlot = frameSlot;
+    FrameQueries& frame = _frames[frameSlot];
+
+    /*The frame engine already waited for this slot's previous submission, so the
+      results are guaranteed available and this read never stalls.*/
+    if (frame.pending && frame.scopeCount > 0)
+    {
+        auto [result, timestamps] = frame.queryPool.getResults<uint64_t>(0, frame.scopeCount * 2,
+                                                                         frame.scopeCount * 2 * sizeof(uint64_t),
+                                                                         sizeof(uint64_t),
+                                                                         vk::QueryResultFlagBits::e64);
+        if (result == vk::Result::eSuccess)
+        {
+            _latestTimings.clear();
+            for (uint32_t scope = 0; scope < frame.scopeCount; scope++)
+            {
+                const uint64_t ticks = timestamps[scope * 2 + 1] - timestamps[scope * 2];
+                _latestTimings.push_back(Timing{ .name = frame.scopeNames[scope],
+                                                 .milliseconds = static_cast<double>(ticks) * _timestampPeriod / 1'000'000.0 });
+            }
+        }
+    }
+
+    commandBuffer.resetQueryPool(frame.queryPool, 0, MaxScopesPerFrame * 2);
+    frame.scopeNames.clear();
+    frame.scopeCount = 0;
+    frame.pending = true;
+}
+
+uint32_t GpuProfiler::beginScope(const vk::raii::CommandBuffer& commandBuffer, const char* name) {
+
+    if (!_supported)
+        return 0;
+
+    FrameQueries& frame = _frames[_currentSlot];
+    if (frame.scopeCount >= MaxScopesPerFrame)
+        return MaxScopesPerFrame; //out of queries - dropped rather than asserted, see endScope
+
+    const uint32_t scopeId = frame.scopeCount++;
+    frame.scopeNames.emplace_back(name);
+    commandBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eTopOfPipe, frame.queryPool, scopeId * 2);
+    return scopeId;
+}
+
+void GpuProfiler::endScope(const vk::raii::CommandBuffer& commandBuffer, uint32_t scopeId) {
+
+    if (!_supported || scopeId >= MaxScopesPerFrame)
+        return;
+
+    //eAllCommands: the end timestamp must not be reordered before the scoped work finishes
+    commandBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, _frames[_currentSlot].queryPool, scopeId * 2 + 1);
+}
+
+nlohmann::json GpuProfiler::report() const {
+
+    nlohmann::json report = nlohmann::json::array();
+    for (const Timing& timing : _latestTimings)
+        report.push_back({ {"name", timing.name}, {"ms", timing.milliseconds} });
+    return report;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "VulkanCommon.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+GPU timings from vk::QueryPool timestamp queries, the other half of every perf
+escalation: the CpuProfiler says how long recording took, this says how long the
+GPU actually ran. Scopes bracket passes with writeTimestamp2 pairs.
+
+One query pool per frame slot, harvested when the slot comes back around the
+frames-in-flight ring - at that point the frame engine has already waited for the
+slot's GPU work, so reading results never stalls. latestTimings()/report() expose
+the most recently completed frame, the latter as JSON matching the CPU-side report.
+*/
+class GpuProfiler {
+public:
+
+    static constexpr uint32_t MaxScopesPerFrame = 32;
+
+    void init(const vk::raii::Device& device,
+              const vk::raii::PhysicalDevice& physicalDevice,
+              uint32_t graphicsQueueFamilyIndex,
+              uint32_t frameCount);
+
+    //Harvests the slot's results from its previous trip around the ring, then resets its pool
+    void beginFrame(uint32_t frameSlot, const vk::raii::CommandBuffer& commandBuffer);
+
+    //Returns a scope id to pass to endScope
+    uint32_t beginScope(const vk::raii::CommandBuffer& commandBuffer, const char* name);
+    void endScope(const vk::raii::CommandBuffer& commandBuffer, uint32_t scopeId);
+
+    struct Timing {
+        std::string name;
+        double milliseconds = 0.0;
+    };
+
+    //Timings of the most recently harvested frame
+    const std::vector<Timing>& latestTimings() const { return _latestTimings; }
+
+    //Same shape as CpuProfiler::report(): [{"name":..., "ms":...}, ...]
+    nlohmann::json report() const;
+
+private:
+
+    struct FrameQueries {
+        vk::raii::QueryPool queryPool = nullptr;
+        std::vector<std::string> scopeNames;
+        uint32_t scopeCount = 0;
+        bool pending = false; //true once the slot's command buffer has been submitted with queries in it
+    };
+
+    std::vector<FrameQueries> _frames;
+    std::vector<Timing> _latestTimings;
+    float _timestampPeriod = 0.0f; //nanoseconds per timestamp tick
+    bool _supported = false;
+    uint32_t _currentSlot = 0;
+};
@@ -0,0 +1,238 @@
+#include "GpuScene.hpp"
+
+#include "ShaderCache.hpp"
+#include "PipelineCacheStore.hpp"
+#include "DescriptorAllocator.hpp"
+#include "UploadManager.hpp"
+
+#include <filesystem>
+#include <vector>
+
+namespace {
+    constexpr const char* BuildDrawsShader = "Shaders/build_draws.comp.spv";
+    constexpr vk::DeviceSize CommandStride = 5 * sizeof(uint32_t); //VkDrawIndexedIndirectCommand
+
+    struct BuildPush {
+        uint32_t objectCount = 0;
+    };
+}
+
+void GpuScene::init(const vk::raii::Device& device,
+                    GpuAllocator& allocator,
+                    ShaderCache& shaderCache,
+                    PipelineCacheStore& pipelineCacheStore,
+                    bool drawIndirectCountAvailable,
+                    bool multiDrawIndirectAvailable) {
+
+    _device = &device;
+    _allocator = &allocator;
+    _shaderCache = &shaderCache;
+    _pipelineCacheStore = &pipelineCacheStore;
+    _drawIndirectCount = drawIndirectCountAvailable;
+    _multiDrawIndirect = multiDrawIndirectAvailable;
+
+    if (!std::filesystem::exists(BuildDrawsShader))
+        return; //no bytecode, no GPU-driven path; the classic draw loop still works
+
+    _shaderCache->preload(BuildDrawsShader);
+
+    const std::array bindings = {
+        vk::DescriptorSetLayoutBinding{ .binding = 0, .descriptorType = vk::DescriptorType::eStorageBuffer,
+                                        .descriptorCount = 1, .stageFlags = vk::ShaderStageFlagBits::eCompute }, //objects
+        vk::DescriptorSetLayoutBinding{ .binding = 1, .descriptorType = vk::DescriptorType::eStorageBuffer,
+                                        .descriptorCount = 1, .stageFlags = vk::ShaderStageFlagBits::eCompute }, //visibility
+        vk::DescriptorSetLayoutBinding{ .binding = 2, .descriptorType = vk::DescriptorType::eStorageBuffer,
+                                        .descriptorCount = 1, .stageFlags = vk::ShaderStageFlagBits::eCompute }, //bucket bases
+        vk::DescriptorSetLayoutBinding{ .binding = 3, .descriptorType = vk::DescriptorType::eStorageBuffer,
+                                        .descriptorCount = 1, .stageFlags = vk::ShaderStageFlagBits::eCompute }, //counts
+        vk::DescriptorSetLayoutBinding{ .binding = 4, .descriptorType = vk::DescriptorType::eStorageBuffer,
+                                        .descriptorCount = 1, .stageFlags = vk::ShaderStageFlagBits::eCompute } }; //commands
+    _buildSetLayout = vk::raii::DescriptorSetLayout(device, vk::DescriptorSetLayoutCreateInfo{
+        .bindingCount = static_cast<uint32_t>(bindings.size()), .pBindings = bindings.data() });
+
+    vk::DescriptorSetLayout setLayout = _buildSetLayout;
+    const vk::PushConstantRange pushRange{ .stageFlags = vk::ShaderStageFlagBits::eCompute, .size = sizeof(BuildPush) };
+    _buildLayout = vk::raii::PipelineLayout(device, vk::PipelineLayoutCreateInfo{
+        .setLayoutCount = 1, .pSetLayouts = &setLayout,
+        .pushConstantRangeCount = 1, .pPushConstantRanges = &pushRange });
+
+    _buildPipeline = vk::raii::Pipeline(device, _pipelineCacheStore->cache(), vk::ComputePipelineCreateInfo{
+        .stage = { .stage = vk::ShaderStageFlagBits::eCompute,
+                   .module = _shaderCache->get(BuildDrawsShader), .pName = "main" },
+        .layout = _buildLayout });
+
+    _available = true;
+}
+
+void GpuScene::releaseBuffers() {
+
+    const auto release = [this](vk::raii::Buffer& buffer, GpuAllocator::Allocation& allocation) {
+        if (static_cast<bool>(*buffer))
+        {
+            buffer = nullptr;
+            _allocator->free(allocation);
+        }
+    };
+    release(_objectBuffer, _objectAllocation);
+    release(_boundsBuffer, _boundsAllocation);
+    release(_visibilityBuffer, _visibilityAllocation);
+    release(_bucketInfoBuffer, _bucketInfoAllocation);
+    release(_commandBuffer, _commandAllocation);
+    release(_countBuffer, _countAllocation);
+}
+
+void GpuScene::setObjects(std::span<const Object> objects, UploadManager& uploads) {
+
+    releaseBuffers();
+    _objectCount = static_cast<uint32_t>(objects.size());
+    if (_objectCount == 0 || !_available)
+        return;
+
+    /*Command regions are sized exactly: count the objects per bucket and lay the
+      regions out back to back, so the atomic slot an object claims is always
+      inside its bucket's region.*/
+    _bucketCapacity.fill(0);
+    for (const Object& object : objects)
+        _bucketCapacity[object.materialBucket % MaxMaterialBuckets]++;
+    uint32_t base = 0;
+    for (uint32_t bucket = 0; bucket < MaxMaterialBuckets; bucket++)
+    {
+        _bucketBase[bucket] = base;
+        base += _bucketCapacity[bucket];
+    }
+
+    const auto makeBuffer = [this](vk::raii::Buffer& buffer, GpuAllocator::Allocation& allocation,
+                                   vk::DeviceSize size, vk::BufferUsageFlags usage) {
+        buffer = vk::raii::Buffer(*_device, vk::BufferCreateInfo{ .size = size,
+                                                                  .usage = usage | vk::BufferUsageFlagBits::eTransferDst,
+                                                                  .sharingMode = vk::SharingMode::eExclusive });
+        allocation = _allocator->allocate(buffer.getMemoryRequirements(), vk::MemoryPropertyFlagBits::eDeviceLocal);
+        buffer.bindMemory(allocation.memory, allocation.offset);
+    };
+
+    makeBuffer(_objectBuffer, _objectAllocation, _objectCount * sizeof(Object), vk::BufferUsageFlagBits::eStorageBuffer);
+    makeBuffer(_boundsBuffer, _boundsAllocation, _objectCount * 8 * sizeof(float), vk::BufferUsageFlagBits::eStorageBuffer);
+    makeBuffer(_visibilityBuffer, _visibilityAllocation, _objectCount * sizeof(uint32_t), vk::BufferUsageFlagBits::eStorageBuffer);
+    makeBuffer(_bucketInfoBuffer, _bucketInfoAllocation, MaxMaterialBuckets * sizeof(uint32_t), vk::BufferUsageFlagBits::eStorageBuffer);
+    makeBuffer(_commandBuffer, _commandAllocation, _objectCount * CommandStride,
+               vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer);
+    makeBuffer(_countBuffer, _countAllocation, MaxMaterialBuckets * sizeof(uint32_t),
+               vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer);
+
+    //The cull pass wants bare center/extents pairs, not whole objects
+    std::vector<float> bounds;
+    bounds.reserve(_objectCount * 8);
+    for (const Object& object : objects)
+    {
+        bounds.insert(bounds.end(), object.center, object.center + 4);
+        bounds.insert(bounds.end(), object.extents, object.extents + 4);
+    }
+
+    uploads.stage(objects.data(), objects.size_bytes(), _objectBuffer, 0);
+    uploads.stage(bounds.data(), bounds.size() * sizeof(float), _boundsBuffer, 0);
+    uploads.stage(_bucketBase.data(), _bucketBase.size() * sizeof(uint32_t), _bucketInfoBuffer, 0);
+    uploads.flushAndWait();
+}
+
+void GpuScene::recordBuildDraws(const vk::raii::CommandBuffer& commandBuffer, DescriptorAllocator& descriptors) {
+
+    if (!_available || _objectCount == 0)
+        return;
+
+    //Counts restart at zero; without drawIndirectCount the stale commands must go too,
+    //because the fallback draws every slot in the region
+    commandBuffer.fillBuffer(_countBuffer, 0, vk::WholeSize, 0);
+    if (!_drawIndirectCount)
+        commandBuffer.fillBuffer(_commandBuffer, 0, vk::WholeSize, 0);
+
+    const std::array clearBarriers = {
+        vk::BufferMemoryBarrier2{ .srcStageMask = vk::PipelineStageFlagBits2::eClear,
+                                  .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+                                  .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+                                  .dstAccessMask = vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite,
+                                  .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+                                  .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+                                  .buffer = _countBuffer, .size = vk::WholeSize },
+        vk::BufferMemoryBarrier2{ .srcStageMask = vk::PipelineStageFlagBits2::eClear,
+                                  .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+                                  .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+                                  .dstAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+                                  .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+                                  .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+                                  .buffer = _commandBuffer, .size = vk::WholeSize } };
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo{ .bufferMemoryBarrierCount = static_cast<uint32_t>(clearBarriers.size()),
+                                                       .pBufferMemoryBarriers = clearBarriers.data() });
+
+    const std::array<vk::DescriptorBufferInfo, 5> bufferInfos = { {
+        { .buffer = _objectBuffer, .range = vk::WholeSize },
+        { .buffer = _visibilityBuffer, .range = vk::WholeSize },
+        { .buffer = _bucketInfoBuffer, .range = vk::WholeSize },
+        { .buffer = _countBuffer, .range = vk::WholeSize },
+        { .buffer = _commandBuffer, .range = vk::WholeSize } } };
+
+    const vk::DescriptorSet set = descriptors.allocateTransient(_buildSetLayout);
+    std::array<vk::WriteDescriptorSet, 5> writes;
+    for (uint32_t binding = 0; binding < writes.size(); binding++)
+        writes[binding] = vk::WriteDescriptorSet{ .dstSet = set, .dstBinding = binding, .descriptorCount = 1,
+                                                  .descriptorType = vk::DescriptorType::eStorageBuffer,
+                                                  .pBufferInfo = &bufferInfos[binding] };
+    _device->updateDescriptorSets(writes, nullptr);
+
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, _buildPipeline);
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, _buildLayout, 0, { set }, {});
+    const BuildPush push{ .objectCount = _objectCount };
+    commandBuffer.pushConstants<BuildPush>(_buildLayout, vk::ShaderStageFlagBits::eCompute, 0, push);
+    commandBuffer.dispatch((_objectCount + 63) / 64, 1, 1);
+
+    const std::array drawBarriers = {
+        vk::BufferMemoryBarrier2{ .srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+                                  .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+                                  .dstStageMask = vk::PipelineStageFlagBits2::eDrawIndirect,
+                                  .dstAccessMask = vk::AccessFlagBits2::eIndirectCommandRead,
+                                  .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+                                  .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+                                  .buffer = _commandBuffer, .size = vk::WholeSize },
+        vk::BufferMemoryBarrier2{ .srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+                                  .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+                                  .dstStageMask = vk::PipelineStageFlagBits2::eDrawIndirect,
+                                  .dstAccessMask = vk::AccessFlagBits2::eIndirectCommandRead,
+                                  .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+                                  .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+                                  .buffer = _countBuffer, .size = vk::WholeSize } };
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo{ .bufferMemoryBarrierCount = static_cast<uint32_t>(drawBarriers.size()),
+                                                       .pBufferMemoryBarriers = drawBarriers.data() });
+}
+
+void GpuScene::recordDraws(const vk::raii::CommandBuffer& commandBuffer) const {
+
+    if (!_available || _objectCount == 0)
+        return;
+
+    for (uint32_t bucket = 0; bucket < MaxMaterialBuckets; bucket++)
+    {
+        if (_bucketCapacity[bucket] == 0)
+            continue;
+
+        const vk::DeviceSize commandOffset = _bucketBase[bucket] * CommandStride;
+        if (_drawIndirectCount)
+        {
+            commandBuffer.drawIndexedIndirectCount(_commandBuffer, commandOffset,
+                                                   _countBuffer, bucket * sizeof(uint32_t),
+                                                   _bucketCapacity[bucket], static_cast<uint32_t>(CommandStride));
+        }
+        else if (_multiDrawIndirect)
+        {
+            //Region was zero-filled this frame: culled slots decode as empty draws
+            commandBuffer.drawIndexedIndirect(_commandBuffer, commandOffset,
+                                              _bucketCapacity[bucket], static_cast<uint32_t>(CommandStride));
+        }
+        else
+        {
+            //Without multiDrawIndirect, drawCount must be 1 - walk the zero-filled
+            //region one command slot at a time instead
+            for (uint32_t slot = 0; slot < _bucketCapacity[bucket]; slot++)
+                commandBuffer.drawIndexedIndirect(_commandBuffer, commandOffset + slot * CommandStride,
+                                                  1, static_cast<uint32_t>(CommandStride));
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "VulkanCommon.hpp"
+#include "GpuAllocator.hpp"
+
+#include <cstdint>
+#include <array>
+#include <span>
+
+class ShaderCache;
+class PipelineCacheStore;
+class DescriptorAllocator;
+class UploadManager;
+
+/*
+GPU-driven draw path. Scene objects live in a device-local storage buffer; after
+DepthPyramid::recordCull() has written per-object visibility, a compute pass
+compacts the survivors into VkDrawIndexedIndirectCommand arrays (one contiguous
+region per material bucket, slots claimed by atomic counters) and the frame
+issues one drawIndexedIndirectCount per bucket. The CPU never touches
+per-object state during the frame - this is what takes the object ceiling from
+the ~30k where the frame thread saturates to the 500k range.
+
+Bucket regions are sized exactly from the object list at setObjects() time, so
+the command buffer never overflows. Without the drawIndirectCount feature the
+command regions are zero-filled each frame and drawn at full capacity instead -
+empty slots cost decode, not shading (one multi-draw per bucket when the device
+has multiDrawIndirect, one call per slot when it does not - drawCount above 1
+requires the feature). Each command's firstInstance carries the
+object index, so shaders reach the object buffer through gl_InstanceIndex.
+*/
+class GpuScene {
+public:
+
+    //Matches the std430 Object struct in Shaders/build_draws.comp
+    struct Object {
+        float transform[16];
+        float center[4];  //world-space AABB, w unused
+        float extents[4]; //half-size, w unused
+        uint32_t indexCount = 0;
+        uint32_t firstIndex = 0;
+        int32_t vertexOffset = 0;
+        uint32_t materialBucket = 0;
+    };
+
+    static constexpr uint32_t MaxMaterialBuckets = 16;
+
+    void init(const vk::raii::Device& device,
+              GpuAllocator& allocator,
+              ShaderCache& shaderCache,
+              PipelineCacheStore& pipelineCacheStore,
+              bool drawIndirectCountAvailable,
+              bool multiDrawIndirectAvailable);
+
+    /*Load-time: (re)builds the device-local buffers and uploads the object list
+      through the transfer queue. Waits for the upload - callers are loading
+      screens, not frames.*/
+    void setObjects(std::span<const Object> objects, UploadManager& uploads);
+
+    uint32_t objectCount() const { return _objectCount; }
+    bool available() const { return _available; }
+
+    //Inputs for DepthPyramid::recordCull()
+    vk::Buffer boundsBuffer() const { return _boundsBuffer; }
+    vk::Buffer visibilityBuffer() const { return _visibilityBuffer; }
+
+    //Compacts visible objects into the indirect command regions; run after recordCull()
+    void recordBuildDraws(const vk::raii::CommandBuffer& commandBuffer, DescriptorAllocator& descriptors);
+
+    /*One indirect draw per non-empty bucket. The caller has bound the graphics
+      pipeline, descriptor sets and index/vertex buffers for the bucket sequence.*/
+    void recordDraws(const vk::raii::CommandBuffer& commandBuffer) const;
+
+private:
+
+    void releaseBuffers();
+
+    const vk::raii::Device* _device = nullptr;
+    GpuAllocator* _allocator = nullptr;
+    ShaderCache* _shaderCache = nullptr;
+    PipelineCacheStore* _pipelineCacheStore = nullptr;
+    bool _drawIndirectCount = false;
+    bool _multiDrawIndirect = false;
+    bool _available = false;
+
+    uint32_t _objectCount = 0;
+    std::array<uint32_t, MaxMaterialBuckets> _bucketBase{};     //first command slot per bucket
+    std::array<uint32_t, MaxMaterialBuckets> _bucketCapacity{}; //objects assigned to the bucket
+
+    vk::raii::Buffer _objectBuffer = nullptr;
+    GpuAllocator::Allocation _objectAllocation;
+    vk::raii::Buffer _boundsBuffer = nullptr;
+    GpuAllocator::Allocation _boundsAllocation;
+    vk::raii::Buffer _visibilityBuffer = nullptr;
+    GpuAllocator::Allocation _visibilityAllocation;
+    vk::raii::Buffer _bucketInfoBuffer = nullptr;
+    GpuAllocator::Allocation _bucketInfoAllocation;
+    vk::raii::Buffer _commandBuffer = nullptr;
+    GpuAllocator::Allocation _commandAllocation;
+    vk::raii::Buffer _countBuffer = nullptr;
+    GpuAllocator::Allocation _countAllocation;
+
+    vk::raii::DescriptorSetLayout _buildSetLayout = nullptr;
+    vk::raii::PipelineLayout _buildLayout = nullptr;
+    vk::raii::Pipeline _buildPipeline = nullptr;
+};
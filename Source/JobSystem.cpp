@@ -0,0 +1,208 @@
+#include "JobSystem.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+    //Which worker this thread is, UINT32_MAX for outside threads (frame thread, streamers)
+    thread_local uint32_t tlsWorkerIndex = UINT32_MAX;
+}
+
+void JobSystem::init(uint32_t workerCount) {
+
+    if (workerCount == 0)
+    {
+        const uint32_t cores = std::thread::hardware_concurrency();
+        workerCount = (cores > 1) ? cores - 1 : 1; //leave a core for the frame thread
+    }
+
+    _jobs = std::vector<Job>(MaxJobsPerFrame);
+    _edges = std::vector<DependencyEdge>(MaxJobsPerFrame);
+    _payloadArena.resize(PayloadArenaSize);
+
+    _queues = std::vector<WorkerQueue>(workerCount);
+    for (uint32_t worker = 0; worker < workerCount; worker++)
+        _workers.emplace_back([this, worker] { workerLoop(worker); });
+}
+
+void JobSystem::shutdown() {
+
+    if (_workers.empty())
+        return;
+
+    waitAll();
+    _stopping.store(true);
+    _workAvailable.notify_all();
+    _workers.clear(); //jthreads join
+    _queues.clear();
+}
+
+void JobSystem::beginFrame() {
+
+    waitAll(); //the arena contract: no job survives its frame
+    _nextJob.store(0, std::memory_order_relaxed);
+    _nextEdge.store(0, std::memory_order_relaxed);
+    _payloadUsed.store(0, std::memory_order_relaxed);
+}
+
+void* JobSystem::allocatePayload(size_t size, size_t alignment) {
+
+    size_t offset = _payloadUsed.load(std::memory_order_relaxed);
+    size_t aligned, next;
+    do
+    {
+        aligned = (offset + alignment - 1) & ~(alignment - 1);
+        next = aligned + size;
+        if (next > _payloadArena.size())
+            throw std::runtime_error("job payload arena exhausted - raise PayloadArenaSize");
+    } while (!_payloadUsed.compare_exchange_weak(offset, next, std::memory_order_relaxed));
+    return _payloadArena.data() + aligned;
+}
+
+JobSystem::JobHandle JobSystem::scheduleImpl(void (*invoke)(void*), void* payload,
+                                             std::span<const JobHandle> dependencies) {
+
+    const uint32_t jobIndex = _nextJob.fetch_add(1, std::memory_order_relaxed);
+    if (jobIndex >= MaxJobsPerFrame)
+        throw std::runtime_error("job arena exhausted - raise MaxJobsPerFrame");
+
+    Job& job = _jobs[jobIndex];
+    job.invoke = invoke;
+    job.payload = payload;
+    job.finished.store(false, std::memory_order_relaxed);
+    job.firstDependent = UINT32_MAX;
+    _unfinishedJobs.fetch_add(1, std::memory_order_relaxed);
+
+    /*Registering against dependencies races with them finishing; the graph mutex
+      makes "append edge" and "walk dependents on completion" atomic with respect
+      to each other. Dependencies already finished just do not count.*/
+    uint32_t pendingDependencies = 0;
+    {
+        std::lock_guard lock(_graphMutex);
+        for (const JobHandle dependency : dependencies)
+        {
+            if (!dependency.valid() || _jobs[dependency.index].finished.load(std::memory_order_acquire))
+                continue;
+
+            const uint32_t edgeIndex = _nextEdge.fetch_add(1, std::memory_order_relaxed);
+            if (edgeIndex >= _edges.size())
+                throw std::runtime_error("job edge arena exhausted - raise MaxJobsPerFrame");
+            _edges[edgeIndex] = { .job = jobIndex, .next = _jobs[dependency.index].firstDependent };
+            _jobs[dependency.index].firstDependent = edgeIndex;
+            pendingDependencies++;
+        }
+        job.remainingDependencies.store(pendingDependencies, std::memory_order_release);
+    }
+
+    if (pendingDependencies == 0)
+        pushReady(jobIndex);
+    return JobHandle{ jobIndex };
+}
+
+void JobSystem::pushReady(uint32_t jobIndex) {
+
+    //Workers keep their own work hot; outside threads spread round-robin
+    uint32_t queueIndex = tlsWorkerIndex;
+    if (queueIndex == UINT32_MAX)
+        queueIndex = _nextPushQueue.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+
+    {
+        std::lock_guard lock(_queues[queueIndex].mutex);
+        _queues[queueIndex].jobs.push_back(jobIndex);
+    }
+    _workAvailable.notify_one();
+}
+
+bool JobSystem::tryExecuteOne(uint32_t preferredQueue) {
+
+    //Own queue from the back (LIFO, cache-warm), steals from the front (FIFO)
+    {
+        WorkerQueue& own = _queues[preferredQueue];
+        std::unique_lock lock(own.mutex);
+        if (!own.jobs.empty())
+        {
+            const uint32_t jobIndex = own.jobs.back();
+            own.jobs.pop_back();
+            lock.unlock();
+            executeJob(jobIndex);
+            return true;
+        }
+    }
+
+    for (size_t offset = 1; offset < _queues.size(); offset++)
+    {
+        WorkerQueue& victim = _queues[(preferredQueue + offset) % _queues.size()];
+        std::unique_lock lock(victim.mutex);
+        if (!victim.jobs.empty())
+        {
+            const uint32_t jobIndex = victim.jobs.front();
+            victim.jobs.pop_front();
+            lock.unlock();
+            executeJob(jobIndex);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::executeJob(uint32_t jobIndex) {
+
+    Job& job = _jobs[jobIndex];
+    job.invoke(job.payload);
+
+    //Completion releases dependents whose last dependency this was
+    std::vector<uint32_t> nowReady;
+    {
+        std::lock_guard lock(_graphMutex);
+        job.finished.store(true, std::memory_order_release);
+        for (uint32_t edge = job.firstDependent; edge != UINT32_MAX; edge = _edges[edge].next)
+        {
+            if (_jobs[_edges[edge].job].remainingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                nowReady.push_back(_edges[edge].job);
+        }
+    }
+    for (const uint32_t ready : nowReady)
+        pushReady(ready);
+
+    _unfinishedJobs.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::workerLoop(uint32_t workerIndex) {
+
+    tlsWorkerIndex = workerIndex;
+    while (true)
+    {
+        if (tryExecuteOne(workerIndex))
+            continue;
+
+        std::unique_lock lock(_sleepMutex);
+        if (_stopping.load(std::memory_order_acquire))
+            return;
+        _workAvailable.wait_for(lock, std::chrono::milliseconds(1));
+        if (_stopping.load(std::memory_order_acquire))
+            return;
+    }
+}
+
+void JobSystem::wait(JobHandle handle) {
+
+    if (!handle.valid())
+        return;
+
+    const uint32_t queueIndex = (tlsWorkerIndex != UINT32_MAX) ? tlsWorkerIndex : 0;
+    while (!_jobs[handle.index].finished.load(std::memory_order_acquire))
+    {
+        if (!tryExecuteOne(queueIndex))
+            std::this_thread::yield();
+    }
+}
+
+void JobSystem::waitAll() {
+
+    const uint32_t queueIndex = (tlsWorkerIndex != UINT32_MAX) ? tlsWorkerIndex : 0;
+    while (_unfinishedJobs.load(std::memory_order_acquire) != 0)
+    {
+        if (!tryExecuteOne(queueIndex))
+            std::this_thread::yield();
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+Shared job scheduler for every subsystem that wants parallelism - command
+recording, shader compilation, streaming - instead of each spawning its own
+threads. One worker per core (minus the frame thread), each with its own deque:
+owners push and pop at the back for cache-warm LIFO execution, idle workers
+steal from the front of someone else's, so load spreads itself across anything
+from the 4-core embedded boxes to 32-core workstations.
+
+Jobs form a graph: schedule() takes the handles a job depends on and the job
+only becomes runnable when all of them have finished. wait() helps - the
+waiting thread executes ready jobs instead of blocking, so waiting on the
+critical path never idles a core.
+
+Job nodes, payloads and dependency edges all come from a frame-scoped arena
+(preallocated once, bump-allocated per frame, reset in beginFrame()), so
+hot-path scheduling does zero heap allocation. The contract is the same as the
+frame engine's: everything scheduled in a frame completes within it.
+*/
+class JobSystem {
+public:
+
+    struct JobHandle {
+        uint32_t index = UINT32_MAX;
+        bool valid() const { return index != UINT32_MAX; }
+    };
+
+    //workerCount of 0 means one per hardware thread, minus one for the frame thread
+    void init(uint32_t workerCount = 0);
+
+    //Joins the workers after draining running jobs
+    void shutdown();
+
+    ~JobSystem() { shutdown(); }
+
+    template <typename F>
+    JobHandle schedule(F&& function, std::span<const JobHandle> dependencies = {}) {
+        using Function = std::decay_t<F>;
+        static_assert(std::is_trivially_destructible_v<Function>,
+                      "job payloads live in the frame arena and are never destructed");
+        void* payload = allocatePayload(sizeof(Function), alignof(Function));
+        new (payload) Function(std::forward<F>(function));
+        return scheduleImpl(+[](void* p) { (*static_cast<Function*>(p))(); }, payload, dependencies);
+    }
+
+    //Executes ready jobs while waiting, so the caller's core keeps contributing
+    void wait(JobHandle handle);
+    void waitAll();
+
+    //Resets the job arena. Every job from the previous frame must have completed.
+    void beginFrame();
+
+    uint32_t workerCount() const { return static_cast<uint32_t>(_workers.size()); }
+
+private:
+
+    static constexpr uint32_t MaxJobsPerFrame = 16384;
+    static constexpr size_t PayloadArenaSize = 1024 * 1024;
+
+    struct Job {
+        void (*invoke)(void*) = nullptr;
+        void* payload = nullptr;
+        std::atomic<uint32_t> remainingDependencies{ 0 };
+        std::atomic<bool> finished{ false };
+        uint32_t firstDependent = UINT32_MAX; //arena-linked list of jobs waiting on this one
+    };
+
+    struct DependencyEdge {
+        uint32_t job = UINT32_MAX;
+        uint32_t next = UINT32_MAX;
+    };
+
+    struct WorkerQueue {
+        std::deque<uint32_t> jobs;
+        std::mutex mutex;
+    };
+
+    JobHandle scheduleImpl(void (*invoke)(void*), void* payload, std::span<const JobHandle> dependencies);
+    void* allocatePayload(size_t size, size_t alignment);
+    void pushReady(uint32_t jobIndex);
+    bool tryExecuteOne(uint32_t preferredQueue);
+    void executeJob(uint32_t jobIndex);
+    void workerLoop(uint32_t workerIndex);
+
+    std::vector<Job> _jobs;                  //fixed pool, bump-allocated
+    std::vector<DependencyEdge> _edges;      //fixed pool, bump-allocated
+    std::vector<std::byte> _payloadArena;
+    std::atomic<uint32_t> _nextJob{ 0 };
+    std::atomic<uint32_t> _nextEdge{ 0 };
+    std::atomic<size_t> _payloadUsed{ 0 };
+    std::atomic<uint32_t> _unfinishedJobs{ 0 };
+
+    std::vector<WorkerQueue> _queues; //one per worker
+    std::vector<std::jthread> _workers;
+    std::mutex _graphMutex; //guards dependency edges between schedule() and job completion
+    std::mutex _sleepMutex;
+    std::condition_variable _workAvailable;
+    std::atomic<bool> _stopping{ false };
+    std::atomic<uint32_t> _nextPushQueue{ 0 }; //round-robin target for non-worker threads
+};
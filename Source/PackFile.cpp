@@ -0,0 +1,198 @@
+#include "PackFile.hpp"
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+uint64_t PackFile::hashName(std::string_view name) {
+    //FNV-1a, same construction the shader cache uses for bytecode
+    uint64_t hash = 14695981039346656037ull;
+    for (const char c : name)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void PackFile::open(const std::filesystem::path& packPath) {
+
+    close();
+
+#ifdef _WIN32
+    _fileHandle = CreateFileW(packPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (_fileHandle == INVALID_HANDLE_VALUE)
+    {
+        _fileHandle = nullptr;
+        throw std::runtime_error("failed to open pack file: " + packPath.string());
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(_fileHandle, &fileSize);
+    _mappingSize = static_cast<size_t>(fileSize.QuadPart);
+
+    _mappingHandle = CreateFileMappingW(_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_mappingHandle == nullptr)
+        throw std::runtime_error("failed to map pack file: " + packPath.string());
+    _mapping = static_cast<const std::byte*>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+    _fd = ::open(packPath.c_str(), O_RDONLY);
+    if (_fd < 0)
+        throw std::runtime_error("failed to open pack file: " + packPath.string());
+
+    struct stat fileInfo{};
+    fstat(_fd, &fileInfo);
+    _mappingSize = static_cast<size_t>(fileInfo.st_size);
+
+    void* mapping = mmap(nullptr, _mappingSize, PROT_READ, MAP_PRIVATE, _fd, 0);
+    _mapping = (mapping == MAP_FAILED) ? nullptr : static_cast<const std::byte*>(mapping);
+#endif
+
+    if (_mapping == nullptr)
+        throw std::runtime_error("failed to map pack file: " + packPath.string());
+
+    if (_mappingSize < sizeof(Header))
+        throw std::runtime_error("pack file truncated: " + packPath.string());
+
+    Header header;
+    std::memcpy(&header, _mapping, sizeof(Header));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version)
+        throw std::runtime_error("pack file has wrong magic or version: " + packPath.string());
+    if (_mappingSize < sizeof(Header) + header.assetCount * sizeof(Entry))
+        throw std::runtime_error("pack file table truncated: " + packPath.string());
+
+    _assetCount = header.assetCount;
+    _entries = reinterpret_cast<const Entry*>(_mapping + sizeof(Header));
+
+    /*Validate every entry's range up front: a corrupt or truncated pack that passes
+      the table check can still point past the mapping, and the first touch of such
+      an entry would SIGBUS in the streamer's worker rather than fail cleanly here.*/
+    for (uint32_t entryIndex = 0; entryIndex < _assetCount; entryIndex++)
+    {
+        const Entry& entry = _entries[entryIndex];
+        if (entry.offset > _mappingSize || entry.size > _mappingSize - entry.offset)
+            throw std::runtime_error("pack file truncated: " + packPath.string());
+    }
+}
+
+const PackFile::Entry* PackFile::find(std::string_view name) const {
+
+    if (_entries == nullptr)
+        return nullptr;
+
+    const uint64_t hash = hashName(name);
+    const Entry* end = _entries + _assetCount;
+    const Entry* it = std::lower_bound(_entries, end, hash,
+                                       [](const Entry& entry, uint64_t value) { return entry.nameHash < value; });
+    return (it != end && it->nameHash == hash) ? it : nullptr;
+}
+
+void PackFile::close() {
+
+#ifdef _WIN32
+    if (_mapping != nullptr)
+        UnmapViewOfFile(_mapping);
+    if (_mappingHandle != nullptr)
+        CloseHandle(_mappingHandle);
+    if (_fileHandle != nullptr)
+        CloseHandle(_fileHandle);
+    _mappingHandle = nullptr;
+    _fileHandle = nullptr;
+#else
+    if (_mapping != nullptr)
+        munmap(const_cast<std::byte*>(_mapping), _mappingSize);
+    if (_fd >= 0)
+        ::close(_fd);
+    _fd = -1;
+#endif
+    _mapping = nullptr;
+    _mappingSize = 0;
+    _entries = nullptr;
+    _assetCount = 0;
+}
+
+void PackFile::bakeFromJson(const std::filesystem::path& manifestFile, const std::filesystem::path& packPath) {
+
+    std::ifstream manifest(manifestFile);
+    if (!manifest)
+        throw std::runtime_error("failed to open manifest: " + manifestFile.string());
+    const nlohmann::json json = nlohmann::json::parse(manifest);
+
+    struct PendingAsset {
+        Entry entry;
+        std::filesystem::path file;
+    };
+    std::vector<PendingAsset> assets;
+
+    const auto typeFromString = [](const std::string& type) {
+        if (type == "texture") return AssetType::Texture;
+        if (type == "mesh") return AssetType::Mesh;
+        if (type == "shader") return AssetType::Shader;
+        return AssetType::Blob;
+    };
+
+    //Manifest paths are relative to the manifest itself, like #include resolution
+    const std::filesystem::path baseDir = manifestFile.parent_path();
+    for (const auto& asset : json.at("assets"))
+    {
+        PendingAsset pending;
+        pending.entry.nameHash = hashName(asset.at("name").get<std::string>());
+        pending.entry.type = typeFromString(asset.value("type", std::string("blob")));
+        pending.file = baseDir / asset.at("file").get<std::string>();
+        pending.entry.size = std::filesystem::file_size(pending.file);
+        assets.push_back(std::move(pending));
+    }
+
+    //The table is binary-searched at runtime, so it is sorted once here
+    std::ranges::sort(assets, {}, [](const PendingAsset& asset) { return asset.entry.nameHash; });
+    for (size_t i = 1; i < assets.size(); i++)
+    {
+        if (assets[i].entry.nameHash == assets[i - 1].entry.nameHash)
+            throw std::runtime_error("duplicate asset name hash in manifest (rename one of the colliding assets)");
+    }
+
+    uint64_t offset = sizeof(Header) + assets.size() * sizeof(Entry);
+    for (PendingAsset& asset : assets)
+    {
+        asset.entry.offset = offset;
+        offset += asset.entry.size;
+    }
+
+    //Temp file + rename, the same crash-safe pattern the pipeline cache uses
+    const std::filesystem::path tempPath = packPath.string() + ".tmp";
+    {
+        std::ofstream pack(tempPath, std::ios::binary | std::ios::trunc);
+        if (!pack)
+            throw std::runtime_error("failed to create pack file: " + packPath.string());
+
+        Header header{};
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.version = Version;
+        header.assetCount = assets.size();
+        pack.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        for (const PendingAsset& asset : assets)
+            pack.write(reinterpret_cast<const char*>(&asset.entry), sizeof(Entry));
+
+        for (const PendingAsset& asset : assets)
+        {
+            std::ifstream source(asset.file, std::ios::binary);
+            if (!source)
+                throw std::runtime_error("failed to open asset file: " + asset.file.string());
+            pack << source.rdbuf();
+        }
+    }
+    std::filesystem::rename(tempPath, packPath);
+}
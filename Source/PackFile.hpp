@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+/*
+Memory-mapped asset pack. One file holds every baked asset behind a fixed-layout
+header and a hash-sorted offset table; open() maps it and lookups are a binary
+search over the table, so "loading" an asset is a pointer into the mapping -
+no parse, no copy, no per-asset file open. The 40k-asset JSON manifest that
+took 11 s to parse opens in microseconds this way, and the OS pages data in
+on first touch instead of front-loading the whole library.
+
+bakeFromJson() is the converter: it reads the existing JSON manifest schema
+({"assets": [{"name", "file", "type"}, ...]}) and writes the pack. It runs at
+build/cook time; shipping units only ever open().
+
+All integers are little-endian; the format is versioned through Header::version
+and open() rejects anything it does not understand.
+*/
+class PackFile {
+public:
+
+    enum class AssetType : uint32_t {
+        Blob = 0,
+        Texture = 1,
+        Mesh = 2,
+        Shader = 3,
+    };
+
+    struct Entry {
+        uint64_t nameHash; //FNV-1a of the asset name
+        uint64_t offset;   //from the start of the file
+        uint64_t size;
+        AssetType type;
+        uint32_t _pad = 0;
+    };
+    static_assert(sizeof(Entry) == 32, "entries are written to disk verbatim");
+
+    //Maps the pack read-only; throws on a missing, truncated or unknown-version file
+    void open(const std::filesystem::path& packPath);
+
+    //Table lookup by name; nullptr when absent
+    const Entry* find(std::string_view name) const;
+
+    //Zero-copy pointer into the mapping; valid for the PackFile's lifetime
+    const std::byte* data(const Entry& entry) const { return _mapping + entry.offset; }
+
+    bool isOpen() const { return _mapping != nullptr; }
+    uint64_t assetCount() const { return _assetCount; }
+
+    static uint64_t hashName(std::string_view name);
+
+    //Build-time converter: bakes a JSON manifest and its referenced files into a pack
+    static void bakeFromJson(const std::filesystem::path& manifestFile, const std::filesystem::path& packPath);
+
+    ~PackFile() { close(); }
+    PackFile() = default;
+    PackFile(const PackFile&) = delete;
+    PackFile& operator=(const PackFile&) = delete;
+
+private:
+
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint64_t assetCount;
+    };
+    static constexpr char Magic[4] = { 'V', 'T', 'P', 'K' };
+    static constexpr uint32_t Version = 1;
+
+    void close();
+
+    const std::byte* _mapping = nullptr;
+    size_t _mappingSize = 0;
+    const Entry* _entries = nullptr; //points into the mapping, sorted by nameHash
+    uint64_t _assetCount = 0;
+
+#ifdef _WIN32
+    void* _fileHandle = nullptr;
+    void* _mappingHandle = nullptr;
+#else
+    int _fd = -1;
+#endif
+};
@@ -0,0 +1,75 @@
+#include "PipelineCacheStore.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+void PipelineCacheStore::init(const vk::raii::Device& device,
+                              const vk::raii::PhysicalDevice& physicalDevice,
+                              const std::filesystem::path& cacheFile) {
+    _device = &device;
+    _physicalDevice = &physicalDevice;
+    _cacheFile = cacheFile;
+
+    std::vector<uint8_t> blob;
+    if (std::ifstream file(cacheFile, std::ios::binary | std::ios::ate); file)
+    {
+        blob.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+    }
+
+    //A stale blob (different GPU or driver update) would just be rejected by the
+    //driver anyway; checking the header ourselves skips uploading megabytes for nothing.
+    if (!isCacheBlobCompatible(blob))
+        blob.clear();
+
+    vk::PipelineCacheCreateInfo createInfo{ .initialDataSize = blob.size(),
+                                            .pInitialData = blob.data() };
+    _cache = vk::raii::PipelineCache(device, createInfo);
+}
+
+bool PipelineCacheStore::isCacheBlobCompatible(const std::vector<uint8_t>& blob) const {
+
+    if (blob.size() < sizeof(vk::PipelineCacheHeaderVersionOne))
+        return false;
+
+    vk::PipelineCacheHeaderVersionOne header;
+    std::memcpy(&header, blob.data(), sizeof(header));
+
+    const auto properties = _physicalDevice->getProperties();
+    return header.headerVersion == vk::PipelineCacheHeaderVersion::eOne &&
+           header.vendorID == properties.vendorID &&
+           header.deviceID == properties.deviceID &&
+           std::memcmp(header.pipelineCacheUUID.data(), properties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+}
+
+vk::raii::PipelineCache PipelineCacheStore::createThreadCache() const {
+    return vk::raii::PipelineCache(*_device, vk::PipelineCacheCreateInfo{});
+}
+
+void PipelineCacheStore::mergeThreadCache(const vk::raii::PipelineCache& threadCache) {
+    std::lock_guard lock(_mergeMutex);
+    _cache.merge(*threadCache);
+}
+
+void PipelineCacheStore::save() const {
+
+    if (_device == nullptr)
+        return;
+
+    const std::vector<uint8_t> blob = _cache.getData();
+    if (blob.empty())
+        return;
+
+    const std::filesystem::path tempFile = _cacheFile.string() + ".tmp";
+    {
+        std::ofstream file(tempFile, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return; //a missing cache only costs the next cold start, never fail over it
+        file.write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+    }
+
+    std::error_code renameError;
+    std::filesystem::rename(tempFile, _cacheFile, renameError);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "VulkanCommon.hpp"
+
+#include <filesystem>
+#include <mutex>
+
+/*
+Persists the Vulkan pipeline cache across runs so warm startups skip shader
+recompilation (cold pipeline builds cost seconds on the slower iGPUs we target).
+
+The blob on disk starts with the standard VkPipelineCacheHeaderVersionOne header;
+we check its vendorID/deviceID/pipelineCacheUUID against the selected physical
+device before handing it to the driver, and silently start with an empty cache
+when it belongs to a different device or driver version.
+
+Pipeline creation from multiple threads can either share cache() (drivers lock
+internally) or use createThreadCache()/mergeThreadCache() to compile completely
+lock-free and fold the results back afterwards.
+*/
+class PipelineCacheStore {
+public:
+
+    void init(const vk::raii::Device& device,
+              const vk::raii::PhysicalDevice& physicalDevice,
+              const std::filesystem::path& cacheFile);
+
+    //The shared cache to pass to pipeline create calls
+    const vk::raii::PipelineCache& cache() const { return _cache; }
+
+    //Empty per-thread cache for lock-free parallel pipeline compilation
+    vk::raii::PipelineCache createThreadCache() const;
+
+    //Folds a per-thread cache back into the shared cache
+    void mergeThreadCache(const vk::raii::PipelineCache& threadCache);
+
+    //Serializes the shared cache to disk (temp file + rename, so a crash never truncates a good cache)
+    void save() const;
+
+private:
+
+    bool isCacheBlobCompatible(const std::vector<uint8_t>& blob) const;
+
+    const vk::raii::Device* _device = nullptr;
+    const vk::raii::PhysicalDevice* _physicalDevice = nullptr;
+    vk::raii::PipelineCache _cache = nullptr;
+    std::filesystem::path _cacheFile;
+    std::mutex _mergeMutex;
+};
@@ -0,0 +1,126 @@
+#include "ShaderCache.hpp"
+
+#include <SDL3/SDL.h>
+
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+    //FNV-1a: fast enough to be free next to file I/O, good enough for bytecode dedup
+    uint64_t hashBytes(const void* data, size_t size) {
+        uint64_t hash = 14695981039346656037ull;
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
+
+void ShaderCache::init(const vk::raii::Device& device, uint32_t workerCount) {
+
+    _device = &device;
+    for (uint32_t worker = 0; worker < workerCount; worker++)
+        _workers.emplace_back([this] { workerLoop(); });
+}
+
+void ShaderCache::preload(const std::string& spirvFile) {
+
+    std::lock_guard lock(_mutex);
+    if (_hashByPath.contains(spirvFile) || _inFlight.contains(spirvFile))
+        return;
+
+    _inFlight.insert(spirvFile);
+    _pendingLoads.push_back(spirvFile);
+    _workAvailable.notify_one();
+}
+
+vk::ShaderModule ShaderCache::get(const std::string& spirvFile) {
+
+    std::unique_lock lock(_mutex);
+
+    //Queued but not finished: wait for the worker instead of loading twice
+    if (_inFlight.contains(spirvFile))
+        _loadFinished.wait(lock, [&] { return !_inFlight.contains(spirvFile); });
+
+    if (!_hashByPath.contains(spirvFile))
+    {
+        //Never queued - load inline on the calling thread
+        lock.unlock();
+        loadAndCreate(spirvFile);
+        lock.lock();
+    }
+
+    const uint64_t hash = _hashByPath.at(spirvFile);
+    if (hash == 0)
+        throw std::runtime_error("failed to load shader: " + spirvFile);
+    return _modulesByHash.at(hash);
+}
+
+void ShaderCache::workerLoop() {
+
+    while (true)
+    {
+        std::string spirvFile;
+        {
+            std::unique_lock lock(_mutex);
+            _workAvailable.wait(lock, [this] { return _stopping || !_pendingLoads.empty(); });
+            if (_stopping)
+                return;
+            spirvFile = std::move(_pendingLoads.front());
+            _pendingLoads.pop_front();
+        }
+        loadAndCreate(spirvFile);
+    }
+}
+
+void ShaderCache::loadAndCreate(const std::string& spirvFile) {
+
+    uint64_t hash = 0;
+    vk::raii::ShaderModule module = nullptr;
+
+    size_t size = 0;
+    if (void* data = SDL_LoadFile(spirvFile.c_str(), &size); data != nullptr)
+    {
+        hash = hashBytes(data, size);
+
+        const bool alreadyCreated = [&] {
+            std::lock_guard lock(_mutex);
+            return _modulesByHash.contains(hash);
+        }();
+
+        //Module creation runs outside the lock so workers really compile in parallel
+        if (!alreadyCreated)
+            module = vk::raii::ShaderModule(*_device, vk::ShaderModuleCreateInfo{ .codeSize = size,
+                                                                                  .pCode = static_cast<const uint32_t*>(data) });
+        SDL_free(data);
+    }
+    else
+    {
+        std::cerr << "ShaderCache: failed to read " << spirvFile << ": " << SDL_GetError() << std::endl;
+    }
+
+    {
+        std::lock_guard lock(_mutex);
+        //Another worker may have created the same bytecode meanwhile - first one in wins
+        if (hash != 0 && !_modulesByHash.contains(hash) && static_cast<bool>(*module))
+            _modulesByHash.emplace(hash, std::move(module));
+        _hashByPath[spirvFile] = hash;
+        _inFlight.erase(spirvFile);
+    }
+    _loadFinished.notify_all();
+}
+
+void ShaderCache::shutdown() {
+
+    {
+        std::lock_guard lock(_mutex);
+        if (_stopping)
+            return;
+        _stopping = true;
+    }
+    _workAvailable.notify_all();
+    _workers.clear(); //jthreads join on destruction
+}
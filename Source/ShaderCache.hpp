@@ -0,0 +1,59 @@
+#pragma once
+
+#include "VulkanCommon.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/*
+SPIR-V shader modules, loaded and created off the main thread. Material systems
+generate permutations by the thousand and serial load-and-create at startup costs
+the better part of a second; a worker pool turns that into overlap with the rest
+of init, and a content-hash index dedups identical bytecode so permutations that
+compile to the same SPIR-V share one vk::ShaderModule.
+
+preload() queues files as soon as they are known; get() returns the module,
+waiting only if that particular file has not finished yet (and loading inline if
+it was never queued at all).
+*/
+class ShaderCache {
+public:
+
+    void init(const vk::raii::Device& device, uint32_t workerCount = 2);
+
+    //Queues the file for load + module creation on the worker pool
+    void preload(const std::string& spirvFile);
+
+    //Module for the file; blocks until a queued load finishes, loads inline if never queued
+    vk::ShaderModule get(const std::string& spirvFile);
+
+    //Joins the workers. Must run before the device is torn down.
+    void shutdown();
+
+    ~ShaderCache() { shutdown(); }
+
+private:
+
+    void workerLoop();
+    void loadAndCreate(const std::string& spirvFile);
+
+    const vk::raii::Device* _device = nullptr;
+
+    std::unordered_map<uint64_t, vk::raii::ShaderModule> _modulesByHash; //content-hash dedup
+    std::unordered_map<std::string, uint64_t> _hashByPath;               //finished loads only; hash 0 = load failed
+    std::deque<std::string> _pendingLoads;
+    std::unordered_set<std::string> _inFlight;
+
+    std::mutex _mutex;
+    std::condition_variable _workAvailable;
+    std::condition_variable _loadFinished;
+    bool _stopping = false;
+    std::vector<std::jthread> _workers;
+};
@@ -0,0 +1,58 @@
+#include "StreamingRing.hpp"
+
+#include <stdexcept>
+
+void StreamingRing::init(const vk::raii::Device& device,
+                         const vk::raii::PhysicalDevice& physicalDevice,
+                         GpuAllocator& allocator,
+                         vk::BufferUsageFlags usage,
+                         vk::DeviceSize capacityPerFrame) {
+    _capacityPerFrame = capacityPerFrame;
+    const vk::DeviceSize totalCapacity = capacityPerFrame * FrameEngine::MaxFramesInFlight;
+
+    _buffer = vk::raii::Buffer(device, vk::BufferCreateInfo{ .size = totalCapacity,
+                                                             .usage = usage,
+                                                             .sharingMode = vk::SharingMode::eExclusive });
+    const auto requirements = _buffer.getMemoryRequirements();
+
+    /*ReBAR detection: a device-local heap the CPU can also map, and big enough
+      (>= 1 GB - the classic 256 MB BAR window is too small to burn on this) to
+      host the ring without crowding out real VRAM users.*/
+    auto properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+    const auto rebarProperties = properties | vk::MemoryPropertyFlagBits::eDeviceLocal;
+    const auto memoryProperties = physicalDevice.getMemoryProperties();
+    for (uint32_t type = 0; type < memoryProperties.memoryTypeCount; type++)
+    {
+        const bool allowed = (requirements.memoryTypeBits & (1u << type)) != 0;
+        const bool rebarType = (memoryProperties.memoryTypes[type].propertyFlags & rebarProperties) == rebarProperties;
+        const bool bigHeap = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[type].heapIndex].size >= 1ull * 1024 * 1024 * 1024;
+        if (allowed && rebarType && bigHeap)
+        {
+            _usingReBar = true;
+            break;
+        }
+    }
+
+    _allocation = allocator.allocate(requirements, _usingReBar ? rebarProperties : properties);
+    _buffer.bindMemory(_allocation.memory, _allocation.offset);
+}
+
+void StreamingRing::beginFrame(uint32_t frameSlot) {
+    _currentSlot = frameSlot;
+    _frameOffsets[frameSlot] = 0;
+}
+
+StreamingRing::Slice StreamingRing::allocate(vk::DeviceSize size, vk::DeviceSize alignment) {
+
+    const vk::DeviceSize regionStart = _currentSlot * _capacityPerFrame;
+    const vk::DeviceSize alignedOffset = (_frameOffsets[_currentSlot] + alignment - 1) & ~(alignment - 1);
+
+    if (alignedOffset + size > _capacityPerFrame)
+        throw std::runtime_error("StreamingRing frame region exhausted - raise capacityPerFrame");
+
+    _frameOffsets[_currentSlot] = alignedOffset + size;
+
+    return Slice{ .buffer = _buffer,
+                  .offset = regionStart + alignedOffset,
+                  .mapped = static_cast<uint8_t*>(_allocation.mapped) + regionStart + alignedOffset };
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "VulkanCommon.hpp"
+#include "FrameEngine.hpp"
+#include "GpuAllocator.hpp"
+
+#include <array>
+#include <cstdint>
+
+/*
+Zero-copy streaming for dynamic geometry (UI, particles): one persistently mapped
+buffer the CPU writes straight into GPU-visible memory every frame - no staging
+copy, no map/unmap. The buffer is split into one region per frame slot; beginFrame()
+resets a region in O(1), which is safe because the frame engine has already waited
+for that slot's previous GPU work by the time the slot is reused.
+
+On hardware with Resizable BAR the backing memory comes from the large
+device-local + host-visible heap, so the GPU reads dynamic geometry at VRAM speed;
+everywhere else it falls back to plain host-visible/coherent memory.
+*/
+class StreamingRing {
+public:
+
+    //A writable slice of the ring: fill mapped, bind buffer at offset
+    struct Slice {
+        vk::Buffer buffer;
+        vk::DeviceSize offset = 0;
+        void* mapped = nullptr;
+    };
+
+    void init(const vk::raii::Device& device,
+              const vk::raii::PhysicalDevice& physicalDevice,
+              GpuAllocator& allocator,
+              vk::BufferUsageFlags usage = vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer,
+              vk::DeviceSize capacityPerFrame = 8ull * 1024 * 1024);
+
+    //O(1) reset of the slot's region; call once per frame before any allocate()
+    void beginFrame(uint32_t frameSlot);
+
+    //Carves an aligned slice out of the current frame's region. Throws when the frame
+    //outgrows capacityPerFrame - that is a content bug, not a case to limp through.
+    Slice allocate(vk::DeviceSize size, vk::DeviceSize alignment = 4);
+
+    bool usingReBar() const { return _usingReBar; }
+
+private:
+
+    vk::raii::Buffer _buffer = nullptr;
+    GpuAllocator::Allocation _allocation;
+    vk::DeviceSize _capacityPerFrame = 0;
+    std::array<vk::DeviceSize, FrameEngine::MaxFramesInFlight> _frameOffsets{}; //write offset within each slot's region
+    uint32_t _currentSlot = 0;
+    bool _usingReBar = false;
+};
@@ -0,0 +1,105 @@
+#include "SubmitManager.hpp"
+
+void SubmitManager::init(const vk::raii::Device& device, uint32_t queueFamilyIndex) {
+
+    _device = &device;
+    _queueFamilyIndex = queueFamilyIndex;
+
+    vk::SemaphoreTypeCreateInfo timelineTypeInfo{ .semaphoreType = vk::SemaphoreType::eTimeline, .initialValue = 0 };
+    _timelineSemaphore = vk::raii::Semaphore(device, vk::SemaphoreCreateInfo{ .pNext = &timelineTypeInfo });
+
+    _currentBatch = takeFreshBatch();
+}
+
+SubmitManager::Batch SubmitManager::takeFreshBatch() {
+
+    if (!_freeBatches.empty())
+    {
+        Batch batch = std::move(_freeBatches.back());
+        _freeBatches.pop_back();
+        return batch;
+    }
+
+    Batch batch;
+    batch.commandPool = vk::raii::CommandPool(*_device, vk::CommandPoolCreateInfo{ .queueFamilyIndex = _queueFamilyIndex });
+    return batch;
+}
+
+void SubmitManager::reclaimCompletedBatches() {
+
+    const uint64_t completed = _timelineSemaphore.getCounterValue();
+    while (!_inFlightBatches.empty() && _inFlightBatches.front().batchValue <= completed)
+    {
+        Batch batch = std::move(_inFlightBatches.front());
+        _inFlightBatches.pop_front();
+
+        batch.commandPool.reset();
+        batch.used = 0;
+        batch.batchValue = 0;
+        _freeBatches.push_back(std::move(batch));
+    }
+}
+
+uint64_t SubmitManager::enqueue(const RecordFunction& record) {
+
+    std::lock_guard lock(_mutex);
+
+    Batch& batch = _currentBatch;
+    if (batch.used == batch.commandBuffers.size())
+    {
+        vk::CommandBufferAllocateInfo allocateInfo{ .commandPool = batch.commandPool,
+                                                    .level = vk::CommandBufferLevel::ePrimary,
+                                                    .commandBufferCount = 1 };
+        batch.commandBuffers.push_back(std::move(vk::raii::CommandBuffers(*_device, allocateInfo).front()));
+    }
+
+    const vk::raii::CommandBuffer& commandBuffer = batch.commandBuffers[batch.used++];
+    commandBuffer.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    record(commandBuffer);
+    commandBuffer.end();
+
+    //The next flush signals this value
+    return _batchCounter + 1;
+}
+
+void SubmitManager::flush(const vk::raii::Queue& queue) {
+
+    std::lock_guard lock(_mutex);
+    reclaimCompletedBatches();
+
+    if (_currentBatch.used == 0)
+        return;
+
+    _batchCounter++;
+    _currentBatch.batchValue = _batchCounter;
+
+    std::vector<vk::CommandBufferSubmitInfo> commandBufferInfos;
+    commandBufferInfos.reserve(_currentBatch.used);
+    for (uint32_t i = 0; i < _currentBatch.used; i++)
+        commandBufferInfos.push_back(vk::CommandBufferSubmitInfo{ .commandBuffer = _currentBatch.commandBuffers[i] });
+
+    vk::SemaphoreSubmitInfo signalInfo{ .semaphore = _timelineSemaphore,
+                                        .value = _batchCounter,
+                                        .stageMask = vk::PipelineStageFlagBits2::eAllCommands };
+    queue.submit2(vk::SubmitInfo2{ .commandBufferInfoCount = static_cast<uint32_t>(commandBufferInfos.size()),
+                                   .pCommandBufferInfos = commandBufferInfos.data(),
+                                   .signalSemaphoreInfoCount = 1,
+                                   .pSignalSemaphoreInfos = &signalInfo });
+
+    _inFlightBatches.push_back(std::move(_currentBatch));
+    _currentBatch = takeFreshBatch();
+}
+
+bool SubmitManager::isComplete(uint64_t ticket) const {
+    return _timelineSemaphore.getCounterValue() >= ticket;
+}
+
+void SubmitManager::wait(uint64_t ticket) const {
+
+    vk::Semaphore timelineSemaphore = _timelineSemaphore;
+    vk::SemaphoreWaitInfo waitInfo{ .semaphoreCount = 1,
+                                    .pSemaphores = &timelineSemaphore,
+                                    .pValues = &ticket };
+    while (_device->waitSemaphores(waitInfo, UINT64_MAX) == vk::Result::eTimeout)
+        ;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "VulkanCommon.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/*
+Batched one-shot submission. Every subsystem that needs "record a few commands and
+submit" (uploads, mipmap generation, layout transitions) goes through here instead
+of issuing its own vkQueueSubmit: each naive submit costs 50-150 us of driver
+overhead and serializes on the queue mutex, and content-heavy frames produce
+hundreds of them. enqueue() records the commands immediately into the current
+batch; flush() - called once per frame - pushes the whole batch as a single
+submit2 and signals a timeline semaphore.
+
+Completion is tracked by ticket: enqueue() returns the timeline value the batch
+will signal, isComplete()/wait() check it. Command pools are recycled once the
+timeline passes their batch, so steady state allocates nothing.
+*/
+class SubmitManager {
+public:
+
+    using RecordFunction = std::function<void(const vk::raii::CommandBuffer&)>;
+
+    void init(const vk::raii::Device& device, uint32_t queueFamilyIndex);
+
+    //Records the commands into the current batch; the returned ticket completes
+    //once the batch has been flushed and has finished on the GPU
+    uint64_t enqueue(const RecordFunction& record);
+
+    //Submits everything enqueued since the last flush as one submit2. Once per frame.
+    void flush(const vk::raii::Queue& queue);
+
+    bool isComplete(uint64_t ticket) const;
+    void wait(uint64_t ticket) const;
+
+private:
+
+    struct Batch {
+        vk::raii::CommandPool commandPool = nullptr;
+        std::vector<vk::raii::CommandBuffer> commandBuffers; //grown on demand, recycled by pool reset
+        uint32_t used = 0;
+        uint64_t batchValue = 0; //timeline value this batch signals
+    };
+
+    Batch takeFreshBatch();
+    void reclaimCompletedBatches(); //caller holds _mutex
+
+    const vk::raii::Device* _device = nullptr;
+    uint32_t _queueFamilyIndex = 0;
+
+    vk::raii::Semaphore _timelineSemaphore = nullptr;
+    uint64_t _batchCounter = 0;
+
+    Batch _currentBatch;
+    std::deque<Batch> _inFlightBatches;
+    std::vector<Batch> _freeBatches;
+    mutable std::mutex _mutex;
+};
@@ -0,0 +1,249 @@
+#include "UploadManager.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+void UploadManager::init(const vk::raii::Device& device,
+                         const vk::raii::PhysicalDevice& physicalDevice,
+                         uint32_t transferQueueIndex,
+                         uint32_t graphicsQueueIndex,
+                         vk::DeviceSize stagingCapacity) {
+    _device = &device;
+    _physicalDevice = &physicalDevice;
+    _transferQueueIndex = transferQueueIndex;
+    _graphicsQueueIndex = graphicsQueueIndex;
+    _stagingCapacity = stagingCapacity;
+
+    _transferQueue = vk::raii::Queue(device, transferQueueIndex, 0);
+
+    //Persistently mapped staging buffer - mapped once here, never unmapped
+    _stagingBuffer = vk::raii::Buffer(device, vk::BufferCreateInfo{ .size = stagingCapacity,
+                                                                    .usage = vk::BufferUsageFlagBits::eTransferSrc,
+                                                                    .sharingMode = vk::SharingMode::eExclusive });
+    const auto memoryRequirements = _stagingBuffer.getMemoryRequirements();
+    _stagingMemory = vk::raii::DeviceMemory(device, vk::MemoryAllocateInfo{ .allocationSize = memoryRequirements.size,
+                                                                            .memoryTypeIndex = findHostVisibleMemoryType() });
+    _stagingBuffer.bindMemory(_stagingMemory, 0);
+    _stagingMapped = _stagingMemory.mapMemory(0, stagingCapacity);
+
+    vk::SemaphoreTypeCreateInfo timelineTypeInfo{ .semaphoreType = vk::SemaphoreType::eTimeline, .initialValue = 0 };
+    _timelineSemaphore = vk::raii::Semaphore(device, vk::SemaphoreCreateInfo{ .pNext = &timelineTypeInfo });
+}
+
+uint32_t UploadManager::findHostVisibleMemoryType() const {
+
+    const auto memoryProperties = _physicalDevice->getMemoryProperties();
+    const auto memoryRequirements = _stagingBuffer.getMemoryRequirements();
+    const auto wantedFlags = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+    for (uint32_t type = 0; type < memoryProperties.memoryTypeCount; type++)
+    {
+        const bool allowedByBuffer = (memoryRequirements.memoryTypeBits & (1u << type)) != 0;
+        if (allowedByBuffer && (memoryProperties.memoryTypes[type].propertyFlags & wantedFlags) == wantedFlags)
+            return type;
+    }
+    throw std::runtime_error("failed to find a host-visible memory type for the staging buffer!");
+}
+
+UploadManager::Batch UploadManager::takeFreshBatch() {
+
+    if (!_freeBatches.empty())
+    {
+        Batch batch = std::move(_freeBatches.back());
+        _freeBatches.pop_back();
+        return batch;
+    }
+
+    Batch batch;
+    batch.commandPool = vk::raii::CommandPool(*_device, vk::CommandPoolCreateInfo{ .queueFamilyIndex = _transferQueueIndex });
+    vk::CommandBufferAllocateInfo allocateInfo{ .commandPool = batch.commandPool,
+                                                .level = vk::CommandBufferLevel::ePrimary,
+                                                .commandBufferCount = 1 };
+    batch.commandBuffer = std::move(vk::raii::CommandBuffers(*_device, allocateInfo).front());
+    return batch;
+}
+
+void UploadManager::reclaimCompletedBatches() {
+
+    const uint64_t completed = _timelineSemaphore.getCounterValue();
+    while (!_inFlightBatches.empty() && _inFlightBatches.front().batchValue <= completed)
+    {
+        Batch batch = std::move(_inFlightBatches.front());
+        _inFlightBatches.pop_front();
+
+        batch.commandPool.reset();
+        _stagingTail = batch.stagingEnd; //everything older than this batch's writes is free again
+        batch.batchValue = 0;
+        batch.stagingEnd = 0;
+        _freeBatches.push_back(std::move(batch));
+    }
+
+    //Fully idle: snap the ring back to the start so large uploads get one contiguous run
+    if (_inFlightBatches.empty() && _pendingCopies.empty())
+    {
+        _stagingHead = 0;
+        _stagingTail = 0;
+    }
+}
+
+bool UploadManager::tryAllocateStaging(vk::DeviceSize size, vk::DeviceSize& offset) {
+
+    if (_stagingHead >= _stagingTail)
+    {
+        if (_stagingCapacity - _stagingHead >= size)
+        {
+            offset = _stagingHead;
+            _stagingHead += size;
+            return true;
+        }
+        //Wrap to the front; the gap at the end frees once the wrapping batch retires
+        if (_stagingTail > size)
+        {
+            offset = 0;
+            _stagingHead = size;
+            return true;
+        }
+    }
+    else if (_stagingTail - _stagingHead > size)
+    {
+        offset = _stagingHead;
+        _stagingHead += size;
+        return true;
+    }
+    return false;
+}
+
+void UploadManager::waitForValue(uint64_t value) const {
+
+    vk::Semaphore timelineSemaphore = _timelineSemaphore;
+    vk::SemaphoreWaitInfo waitInfo{ .semaphoreCount = 1,
+                                    .pSemaphores = &timelineSemaphore,
+                                    .pValues = &value };
+    while (_device->waitSemaphores(waitInfo, UINT64_MAX) == vk::Result::eTimeout)
+        ;
+}
+
+void UploadManager::stage(const void* data, vk::DeviceSize size, vk::Buffer dstBuffer, vk::DeviceSize dstOffset) {
+
+    if (size > _stagingCapacity)
+        throw std::runtime_error("upload larger than the staging buffer - split it or grow stagingCapacity");
+
+    reclaimCompletedBatches();
+
+    vk::DeviceSize srcOffset = 0;
+    while (!tryAllocateStaging(size, srcOffset))
+    {
+        /*No contiguous staging room: submit what is pending and retire the oldest
+          batch in flight. An empty ring always has room, so this terminates.*/
+        flush();
+        waitForValue(_inFlightBatches.front().batchValue);
+        reclaimCompletedBatches();
+    }
+
+    std::memcpy(static_cast<uint8_t*>(_stagingMapped) + srcOffset, data, static_cast<size_t>(size));
+    _pendingCopies.push_back(PendingCopy{ .dstBuffer = dstBuffer, .dstOffset = dstOffset, .srcOffset = srcOffset, .size = size });
+}
+
+void UploadManager::flush() {
+
+    if (_pendingCopies.empty())
+        return;
+
+    reclaimCompletedBatches();
+    Batch batch = takeFreshBatch();
+    const vk::raii::CommandBuffer& commandBuffer = batch.commandBuffer;
+    commandBuffer.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+    for (const PendingCopy& copy : _pendingCopies)
+    {
+        vk::BufferCopy region{ .srcOffset = copy.srcOffset, .dstOffset = copy.dstOffset, .size = copy.size };
+        commandBuffer.copyBuffer(_stagingBuffer, copy.dstBuffer, region);
+    }
+
+    /*Release the destination ranges to the graphics family. When both indices are the
+      same family this is an ordinary memory barrier and the driver ignores the indices.*/
+    std::vector<vk::BufferMemoryBarrier2> releaseBarriers;
+    releaseBarriers.reserve(_pendingCopies.size());
+    for (const PendingCopy& copy : _pendingCopies)
+    {
+        releaseBarriers.push_back(vk::BufferMemoryBarrier2{
+            .srcStageMask = vk::PipelineStageFlagBits2::eCopy,
+            .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+            .srcQueueFamilyIndex = _transferQueueIndex,
+            .dstQueueFamilyIndex = _graphicsQueueIndex,
+            .buffer = copy.dstBuffer,
+            .offset = copy.dstOffset,
+            .size = copy.size });
+    }
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo{ .bufferMemoryBarrierCount = static_cast<uint32_t>(releaseBarriers.size()),
+                                                       .pBufferMemoryBarriers = releaseBarriers.data() });
+    commandBuffer.end();
+
+    _submittedBatches++;
+    batch.batchValue = _submittedBatches;
+    batch.stagingEnd = _stagingHead;
+
+    vk::SemaphoreSubmitInfo signalInfo{ .semaphore = _timelineSemaphore,
+                                        .value = _submittedBatches,
+                                        .stageMask = vk::PipelineStageFlagBits2::eCopy };
+    vk::CommandBufferSubmitInfo commandBufferInfo{ .commandBuffer = commandBuffer };
+    _transferQueue.submit2(vk::SubmitInfo2{ .commandBufferInfoCount = 1,
+                                            .pCommandBufferInfos = &commandBufferInfo,
+                                            .signalSemaphoreInfoCount = 1,
+                                            .pSignalSemaphoreInfos = &signalInfo });
+
+    _inFlightBatches.push_back(std::move(batch));
+
+    //Append rather than replace: several batches can be submitted between graphics
+    //acquires (stage() flushes mid-frame when the ring fills) and every release
+    //still needs its matching acquire
+    _unacquiredCopies.insert(_unacquiredCopies.end(), _pendingCopies.begin(), _pendingCopies.end());
+    _pendingCopies.clear();
+}
+
+void UploadManager::flushAndWait() {
+
+    flush();
+    waitForValue(_submittedBatches);
+    reclaimCompletedBatches();
+}
+
+vk::SemaphoreSubmitInfo UploadManager::graphicsWaitInfo() const {
+    return vk::SemaphoreSubmitInfo{ .semaphore = _timelineSemaphore,
+                                    .value = _submittedBatches,
+                                    .stageMask = vk::PipelineStageFlagBits2::eAllCommands };
+}
+
+void UploadManager::recordGraphicsAcquire(const vk::raii::CommandBuffer& commandBuffer) {
+
+    if (_unacquiredCopies.empty())
+        return;
+
+    if (_transferQueueIndex == _graphicsQueueIndex)
+    {
+        //Same family: the release already collapsed to a plain barrier, nothing to acquire
+        _unacquiredCopies.clear();
+        return;
+    }
+
+    std::vector<vk::BufferMemoryBarrier2> acquireBarriers;
+    acquireBarriers.reserve(_unacquiredCopies.size());
+    for (const PendingCopy& copy : _unacquiredCopies)
+    {
+        acquireBarriers.push_back(vk::BufferMemoryBarrier2{
+            .dstStageMask = vk::PipelineStageFlagBits2::eAllCommands,
+            .dstAccessMask = vk::AccessFlagBits2::eMemoryRead,
+            .srcQueueFamilyIndex = _transferQueueIndex,
+            .dstQueueFamilyIndex = _graphicsQueueIndex,
+            .buffer = copy.dstBuffer,
+            .offset = copy.dstOffset,
+            .size = copy.size });
+    }
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo{ .bufferMemoryBarrierCount = static_cast<uint32_t>(acquireBarriers.size()),
+                                                       .pBufferMemoryBarriers = acquireBarriers.data() });
+
+    /*Consumed: re-acquiring an already-acquired range on a later frame would be an
+      acquire without a matching release, and retained handles would dangle once a
+      destination buffer is recreated (e.g. GpuScene::setObjects growing its buffers).*/
+    _unacquiredCopies.clear();
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "VulkanCommon.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/*
+Staging uploads on the dedicated transfer queue. Discrete GPUs expose a transfer-only
+queue family backed by the DMA engine; copies submitted there run concurrently with
+rendering instead of stalling _graphicsQueue for whole frames during big asset loads.
+
+Usage: stage() as many copies as you like (data is memcpy'd into a persistently
+mapped staging buffer), flush() once to submit them as a single batch, then make the
+consuming graphics submit wait on graphicsWaitInfo() and record acquire barriers with
+recordGraphicsAcquire(). When the device has no separate transfer family everything
+still works - the batch just runs on the graphics family and the queue-ownership
+transfer barriers collapse to plain memory barriers.
+*/
+class UploadManager {
+public:
+
+    void init(const vk::raii::Device& device,
+              const vk::raii::PhysicalDevice& physicalDevice,
+              uint32_t transferQueueIndex,
+              uint32_t graphicsQueueIndex,
+              vk::DeviceSize stagingCapacity = 64ull * 1024 * 1024);
+
+    /*Copies the data into the staging ring and queues a copy into dstBuffer. Staging
+      space recycles as submitted batches retire on the timeline; only when the ring is
+      genuinely full does this block, and then just until the oldest batch completes.*/
+    void stage(const void* data, vk::DeviceSize size, vk::Buffer dstBuffer, vk::DeviceSize dstOffset);
+
+    //Submits every pending copy as one batch on the transfer queue, with queue-ownership
+    //release barriers for the graphics family. No-op when nothing is staged.
+    void flush();
+
+    //Semaphore wait to chain into the graphics submit that first consumes the last batch
+    vk::SemaphoreSubmitInfo graphicsWaitInfo() const;
+
+    /*Records the matching queue-ownership acquire barriers on the graphics side and
+      consumes the handoff: each released range is acquired exactly once, so calling
+      this every frame is safe - idle frames simply record nothing.*/
+    void recordGraphicsAcquire(const vk::raii::CommandBuffer& commandBuffer);
+
+    //flush() plus a host wait for the batch - for load-time paths where blocking is fine
+    void flushAndWait();
+
+    bool hasDedicatedTransferQueue() const { return _transferQueueIndex != _graphicsQueueIndex; }
+
+private:
+
+    struct PendingCopy {
+        vk::Buffer dstBuffer;
+        vk::DeviceSize dstOffset;
+        vk::DeviceSize srcOffset;
+        vk::DeviceSize size;
+    };
+
+    /*One pool+buffer per submitted batch, recycled off the timeline counter like
+      SubmitManager's batches - a buffer is only re-begun once the GPU is provably
+      done with it. stagingEnd is the ring write position when the batch was
+      submitted; retiring the batch hands that much staging space back.*/
+    struct Batch {
+        vk::raii::CommandPool commandPool = nullptr;
+        vk::raii::CommandBuffer commandBuffer = nullptr;
+        uint64_t batchValue = 0;
+        vk::DeviceSize stagingEnd = 0;
+    };
+
+    uint32_t findHostVisibleMemoryType() const;
+    Batch takeFreshBatch();
+    void reclaimCompletedBatches();
+    bool tryAllocateStaging(vk::DeviceSize size, vk::DeviceSize& offset);
+    void waitForValue(uint64_t value) const;
+
+    const vk::raii::Device* _device = nullptr;
+    const vk::raii::PhysicalDevice* _physicalDevice = nullptr;
+    uint32_t _transferQueueIndex = 0;
+    uint32_t _graphicsQueueIndex = 0;
+
+    vk::raii::Queue _transferQueue = nullptr;
+
+    /*Staging is a ring: _stagingHead is where the next stage() writes, _stagingTail
+      the start of the oldest bytes a still-running batch may read. Both reset to
+      zero whenever nothing is pending or in flight.*/
+    vk::raii::Buffer _stagingBuffer = nullptr;
+    vk::raii::DeviceMemory _stagingMemory = nullptr;
+    void* _stagingMapped = nullptr;
+    vk::DeviceSize _stagingCapacity = 0;
+    vk::DeviceSize _stagingHead = 0;
+    vk::DeviceSize _stagingTail = 0;
+
+    vk::raii::Semaphore _timelineSemaphore = nullptr;
+    uint64_t _submittedBatches = 0;
+    std::deque<Batch> _inFlightBatches;
+    std::vector<Batch> _freeBatches;
+
+    std::vector<PendingCopy> _pendingCopies;
+    std::vector<PendingCopy> _unacquiredCopies; //released ranges the graphics side has yet to acquire
+};
@@ -0,0 +1,6 @@
+#pragma once
+
+//This macro is used so we can use {.name1 = ... , .name2 = ...} in constructors for vulkan classes
+#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
+#include <vulkan/vulkan.h>
+#include <vulkan/vulkan_raii.hpp>
@@ -2,16 +2,45 @@
 #include <SDL3/SDL_main.h>
 #include <SDL3/SDL_vulkan.h>
 
-//This macro is used so we can use {.name1 = ... , .name2 = ...} in constructors for vulkan classes
-#define VULKAN_HPP_NO_STRUCT_CONSTRUCTORS
-#include <vulkan/vulkan.h>
-#include <vulkan/vulkan_raii.hpp>
+#include "VulkanCommon.hpp"
+#include "FrameEngine.hpp"
+#include "CommandRecorder.hpp"
+#include "PipelineCacheStore.hpp"
+#include "UploadManager.hpp"
+#include "GpuAllocator.hpp"
+#include "AppConfig.hpp"
+#include "CpuProfiler.hpp"
+#include "GpuProfiler.hpp"
+#include "ShaderCache.hpp"
+#include "StreamingRing.hpp"
+#include "SubmitManager.hpp"
+#include "DescriptorAllocator.hpp"
+#include "BindlessTextures.hpp"
+#include "DepthPyramid.hpp"
+#include "GpuScene.hpp"
+#include "PackFile.hpp"
+#include "AssetStreamer.hpp"
+#include "JobSystem.hpp"
+#include "AsyncCompute.hpp"
+#include "FrameArena.hpp"
+#include "FrameStats.hpp"
 
 #include <nlohmann/json.hpp>
 #include <glm/glm.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
 
 
+//Build-type default for validation; the config file or the
+//VULKAN_TUTORIAL_VALIDATION environment variable override it at runtime
 #ifdef NDEBUG
 constexpr bool enableValidationLayers = false;
 #else
@@ -30,28 +59,90 @@ public:
 
 private:
 
-    SDL_Window* _window = nullptr;
     vk::raii::Context  _context;
     vk::raii::Instance _instance = nullptr;
     vk::raii::DebugUtilsMessengerEXT _debugMessenger = nullptr;
     vk::raii::PhysicalDevice _physicalDevice = nullptr;
     vk::raii::Device _device = nullptr;
 
-    vk::raii::SurfaceKHR _surface = nullptr;
-
-    /*There could be a posibility that one queue is for graphics and anohter for presenting. 
+    /*There could be a posibility that one queue is for graphics and anohter for presenting.
       Most likely both will be the same. But we need a uniform approach.
       We make a search that prefers a queue that supports both for improved performance.
     */
     vk::raii::Queue _graphicsQueue = nullptr;
     vk::raii::Queue _presentQueue = nullptr;
-
-
-    vk::raii::SwapchainKHR _swapChain = nullptr;
-    std::vector<vk::Image> _swapChainImages;
-    vk::Format _swapChainImageFormat = vk::Format::eUndefined;
-    vk::Extent2D _swapChainExtent;
-    std::vector<vk::raii::ImageView> _swapChainImageViews;
+    uint32_t _graphicsQueueIndex = UINT32_MAX;
+    uint32_t _presentQueueIndex = UINT32_MAX;
+    uint32_t _transferQueueIndex = UINT32_MAX;
+    uint32_t _computeQueueIndex = UINT32_MAX;
+
+    JobSystem _jobSystem;
+    FrameArena _frameArena;
+    FrameEngine _frameEngine;
+    CommandRecorder _commandRecorder;
+    PipelineCacheStore _pipelineCacheStore;
+    UploadManager _uploadManager;
+    GpuAllocator _gpuAllocator;
+    AppConfig _config;
+    CpuProfiler _startupProfiler;
+    GpuProfiler _gpuProfiler;
+    ShaderCache _shaderCache;
+    StreamingRing _streamingRing;
+    SubmitManager _submitManager;
+    DescriptorAllocator _descriptorAllocator;
+    BindlessTextures _bindlessTextures;
+    bool _descriptorIndexingSupported = false; //set in createLogicalDevice(), gates the bindless path
+    DepthPyramid _depthPyramid;
+    GpuScene _gpuScene;
+    bool _drawIndirectCountSupported = false;
+    bool _multiDrawIndirectSupported = false;
+    PackFile _packFile;
+    AssetStreamer _assetStreamer;
+    AsyncCompute _asyncCompute;
+    FrameStats _frameStats;
+    std::string _validationMode; //"off", "errors" or "full" - see AppConfig::validationMode
+    bool _headless = false;
+
+    //Headless render targets: color images instead of swapchain images, plus a
+    //host-visible readback buffer each. A target's readback contents are safely
+    //readable once its frame slot has come back around the frames-in-flight ring.
+    struct OffscreenTarget {
+        vk::raii::Image image = nullptr;
+        GpuAllocator::Allocation imageAllocation;
+        vk::raii::Buffer readbackBuffer = nullptr;
+        GpuAllocator::Allocation readbackAllocation;
+    };
+    std::vector<OffscreenTarget> _offscreenTargets;
+
+    //Instance enumeration running concurrently with SDL window creation; see init()
+    std::future<std::vector<vk::LayerProperties>> _layerEnumeration;
+    std::future<std::vector<vk::ExtensionProperties>> _extensionEnumeration;
+
+
+    /*Per-window presentation state. The video-wall deployments drive 2-6 displays
+      from one device, so everything that used to be "the" window/surface/swapchain
+      is one of these per output. Window 0 is the primary: shared offscreen targets
+      (depth, HiZ pyramid) track its extent. In headless mode a single entry carries
+      the offscreen images through the same record path with no window, surface or
+      swapchain behind it.*/
+    struct WindowSurface {
+        SDL_Window* window = nullptr;
+        vk::raii::SurfaceKHR surface = nullptr;
+        vk::raii::SwapchainKHR swapChain = nullptr;
+        std::vector<vk::Image> images;
+        vk::Format imageFormat = vk::Format::eUndefined;
+        vk::Extent2D extent;
+        std::vector<vk::raii::ImageView> imageViews;
+        /*One render-finished semaphore per swapchain image (not per frame in flight):
+          presentation may still be reading an image when the frame slot comes back around.*/
+        std::vector<vk::raii::Semaphore> renderFinishedSemaphores;
+        //One acquire semaphore per frame slot; surfaces own these because every window acquires independently
+        std::vector<vk::raii::Semaphore> acquireSemaphores;
+        bool dirty = false; //set on resize or when acquire/present reports out-of-date/suboptimal
+        uint32_t acquiredImage = 0;
+        bool acquiredThisFrame = false;
+    };
+    std::vector<WindowSurface> _windows;
 
     std::vector<const char*> _requiredDeviceExtensions = {
             vk::KHRSwapchainExtensionName,
@@ -61,34 +152,119 @@ private:
     };
 
     void init() {
-        if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS))
-            throw std::runtime_error("Failed to init SDL");
+        _config = AppConfig::load("config.json");
+        _validationMode = resolveValidationMode();
+        _headless = _config.headless || (std::getenv("VULKAN_TUTORIAL_HEADLESS") != nullptr);
+        _frameStats.init("telemetry.ndjson", _config.hitchThresholdMs);
+        //One scheduler for every parallel subsystem, sized to the machine
+        _jobSystem.init();
+        //Per-frame scratch containers allocate from here; reset once per frame, never freed piecemeal
+        _frameArena.init();
+
+        //No swapchain without a surface; everything else in the extension list still applies
+        if (_headless)
+            std::erase_if(_requiredDeviceExtensions,
+                          [](const char* extension) { return strcmp(extension, vk::KHRSwapchainExtensionName) == 0; });
 
-        if (!SDL_Vulkan_LoadLibrary(nullptr))
-            throw std::runtime_error("Failed to load vulkan library");
+        {
+            auto timer = _startupProfiler.scope("openAssetPack");
+            /*The pack replaces per-asset JSON configs; when only the manifest exists
+              (developer checkout) it is baked on the spot, cooked builds ship the pack.*/
+            if (!std::filesystem::exists("assets.pack") && std::filesystem::exists("asset_manifest.json"))
+                PackFile::bakeFromJson("asset_manifest.json", "assets.pack");
+            if (std::filesystem::exists("assets.pack")) {
+                _packFile.open("assets.pack");
+                _assetStreamer.init(_packFile);
+            }
+        }
 
-        _window = SDL_CreateWindow("Vulkan Window", 800, 600, SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE);
-        if (_window == NULL) {
-            SDL_Log("SDL_CreateWindow: %s", SDL_GetError());
-            return;
+        {
+            auto timer = _startupProfiler.scope("initSDL");
+            //SDL_INIT_VIDEO costs ~200 ms on display-less render nodes before failing, so headless skips it
+            if (!SDL_Init(_headless ? SDL_INIT_EVENTS : (SDL_INIT_VIDEO | SDL_INIT_EVENTS)))
+                throw std::runtime_error("Failed to init SDL");
+
+            if (!_headless && !SDL_Vulkan_LoadLibrary(nullptr))
+                throw std::runtime_error("Failed to load vulkan library");
         }
 
-        initVulkanInstance();
-        setupDebugMessenger();
-        createSurface();
-        pickPhysicalDevice();
-        createLogicalDevice();
-        createSwapChain();
-        createImageViews();
-
-        // JSON demo
-        nlohmann::json config = {
-            {"window", {
-                {"width", 800},
-                {"height", 600}
-            }}
-        };
-        std::cout << "Config JSON: " << config.dump(2) << std::endl;
+        /*Developer machines with 15+ layers installed (RenderDoc, OBS, Steam overlays)
+          pay for every layer manifest parse during instance enumeration. Kick the
+          enumeration off now so it runs while SDL creates the window (~100 ms on
+          Wayland) instead of after it; initVulkanInstance() collects the results.*/
+        _layerEnumeration = std::async(std::launch::async, [this] { return _context.enumerateInstanceLayerProperties(); });
+        _extensionEnumeration = std::async(std::launch::async, [this] { return _context.enumerateInstanceExtensionProperties(); });
+
+        if (!_headless) {
+            auto timer = _startupProfiler.scope("createWindows");
+            createWindows();
+        }
+
+        {
+            auto timer = _startupProfiler.scope("initVulkanInstance");
+            initVulkanInstance();
+        }
+        {
+            auto timer = _startupProfiler.scope("setupDebugMessenger");
+            setupDebugMessenger();
+        }
+        if (!_headless) {
+            auto timer = _startupProfiler.scope("createSurface");
+            createSurface();
+        }
+        {
+            auto timer = _startupProfiler.scope("pickPhysicalDevice");
+            pickPhysicalDevice();
+        }
+        {
+            auto timer = _startupProfiler.scope("createLogicalDevice");
+            createLogicalDevice();
+        }
+        {
+            auto timer = _startupProfiler.scope("initDeviceSubsystems");
+            //Pipeline creation (as it lands) goes through this cache so warm startups skip shader recompilation
+            _pipelineCacheStore.init(_device, _physicalDevice, "pipeline_cache.bin");
+            _uploadManager.init(_device, _physicalDevice, _transferQueueIndex, _graphicsQueueIndex);
+            //All vertex/uniform/texture memory goes through the pooled allocator, never raw vkAllocateMemory
+            _gpuAllocator.init(_device, _physicalDevice);
+            //Shader permutations preload + create on these workers while the rest of init runs
+            _shaderCache.init(_device);
+            //Dynamic geometry (UI, particles) is CPU-written straight into this mapped ring
+            _streamingRing.init(_device, _physicalDevice, _gpuAllocator);
+            //One-shot command work (transitions, mip generation) batches through here, one submit2 per frame
+            _submitManager.init(_device, _graphicsQueueIndex);
+            //Texture materials hold indices into this table instead of their own descriptor sets
+            _bindlessTextures.init(_device, _descriptorIndexingSupported);
+            //Depth target + HiZ occlusion pyramid; targets themselves are created with the swapchain
+            _depthPyramid.init(_device, _physicalDevice, _gpuAllocator, _shaderCache, _pipelineCacheStore);
+            //Scene objects and their indirect draw commands live GPU-side from here on
+            _gpuScene.init(_device, _gpuAllocator, _shaderCache, _pipelineCacheStore,
+                           _drawIndirectCountSupported, _multiDrawIndirectSupported);
+            //Compute dispatches overlap graphics when the hardware has a distinct compute family
+            _asyncCompute.init(_device, _computeQueueIndex, _graphicsQueueIndex, _shaderCache, _pipelineCacheStore);
+        }
+        if (_headless) {
+            auto timer = _startupProfiler.scope("createOffscreenTargets");
+            createOffscreenTargets();
+        } else {
+            auto timer = _startupProfiler.scope("createSwapChains");
+            for (WindowSurface& windowSurface : _windows)
+                createSwapChain(windowSurface);
+        }
+        {
+            auto timer = _startupProfiler.scope("createImageViews");
+            for (WindowSurface& windowSurface : _windows)
+                createImageViews(windowSurface);
+            _depthPyramid.create(_windows[0].extent); //shared offscreen targets track the primary window
+        }
+        {
+            auto timer = _startupProfiler.scope("createFrameEngine");
+            createFrameEngine();
+        }
+
+        //Per-phase startup timings: field units vary 0.8-4.0 s across driver versions
+        //and this is how we find out which phase is responsible
+        std::cout << "Startup timing: " << _startupProfiler.report().dump(2) << std::endl;
 
         // glm demo
         glm::vec3 a(1.0f, 0.0f, 0.0f);
@@ -108,12 +284,17 @@ private:
 
         auto requiredLayers = getRequiredLayers();
         // Check if the required layers are supported by the Vulkan implementation.
-        auto layerProperties = _context.enumerateInstanceLayerProperties();
+        // The enumeration was started back in init(); by now it has usually finished,
+        // so get() costs nothing. Membership checks go through a hashed set instead
+        // of a linear strcmp scan per required name.
+        const auto layerProperties = _layerEnumeration.get();
+        std::unordered_set<std::string_view> availableLayers;
+        for (auto const& layerProperty : layerProperties)
+            availableLayers.emplace(layerProperty.layerName.data());
+
         for (auto const& requiredLayer : requiredLayers)
         {
-            if (std::ranges::none_of(layerProperties,
-                                     [requiredLayer](auto const& layerProperty)
-                                     { return strcmp(layerProperty.layerName, requiredLayer) == 0; }))
+            if (!availableLayers.contains(requiredLayer))
             {
                 throw std::runtime_error("Required layer not supported: " + std::string(requiredLayer));
             }
@@ -122,12 +303,14 @@ private:
         // Get the required extensions.
         auto requiredExtensions = getRequiredExtensions();
         // Check if the required extensions are supported by the Vulkan implementation.
-        auto extensionProperties = _context.enumerateInstanceExtensionProperties();
+        const auto extensionProperties = _extensionEnumeration.get();
+        std::unordered_set<std::string_view> availableExtensions;
+        for (auto const& extensionProperty : extensionProperties)
+            availableExtensions.emplace(extensionProperty.extensionName.data());
+
         for (auto const & requiredExtension : requiredExtensions)
         {
-            if (std::ranges::none_of(extensionProperties,
-                                     [requiredExtension](auto const& extensionProperty)
-                                     { return strcmp(extensionProperty.extensionName, requiredExtension) == 0; }))
+            if (!availableExtensions.contains(requiredExtension))
             {
                 throw std::runtime_error("Required extension not supported: " + std::string(requiredExtension));
             }
@@ -143,79 +326,527 @@ private:
         _instance = vk::raii::Instance(_context, createInfo);
     }
 
+    /*One OS window per configured output, round-robined across the connected
+      displays. The video-wall units used to run one process (and one full device
+      initialization) per display; now every output hangs off this single device.*/
+    void createWindows() {
+        int displayCount = 0;
+        SDL_DisplayID* displays = SDL_GetDisplays(&displayCount);
+
+        _windows.resize(static_cast<size_t>(std::max(1, _config.windowCount)));
+        for (size_t windowIndex = 0; windowIndex < _windows.size(); windowIndex++)
+        {
+            const std::string title = (_windows.size() == 1)
+                ? "Vulkan Window"
+                : "Vulkan Window " + std::to_string(windowIndex + 1);
+            SDL_Window* window = SDL_CreateWindow(title.c_str(), _config.windowWidth, _config.windowHeight, SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE);
+            if (window == nullptr) {
+                SDL_Log("SDL_CreateWindow: %s", SDL_GetError());
+                throw std::runtime_error("Failed to create window");
+            }
+            if (displays != nullptr && displayCount > 0)
+            {
+                const SDL_DisplayID display = displays[windowIndex % displayCount];
+                SDL_SetWindowPosition(window, SDL_WINDOWPOS_CENTERED_DISPLAY(display), SDL_WINDOWPOS_CENTERED_DISPLAY(display));
+            }
+            _windows[windowIndex].window = window;
+        }
+        SDL_free(displays);
+    }
+
     void createSurface() {
-        VkSurfaceKHR surface;
-        if (!SDL_Vulkan_CreateSurface(_window, *_instance, nullptr, &surface)) {
-            throw std::runtime_error("failed to create window surface!");
+        for (WindowSurface& windowSurface : _windows)
+        {
+            VkSurfaceKHR surface;
+            if (!SDL_Vulkan_CreateSurface(windowSurface.window, *_instance, nullptr, &surface)) {
+                throw std::runtime_error("failed to create window surface!");
+            }
+            //The RAII handles the destruction of the surface so we dont need to use SDL_Vulkan_DestroySurface
+            windowSurface.surface = vk::raii::SurfaceKHR(_instance, surface);
         }
-        //The RAII handles the destruction of the surface so we dont need to use SDL_Vulkan_DestroySurface
-        _surface = vk::raii::SurfaceKHR(_instance, surface);
     }
 
     void mainLoop() {
-         // Main loop
+        using clock = std::chrono::steady_clock;
+        //Simulation advances in fixed steps regardless of render rate, so game state
+        //stays deterministic whether we render at 30 or 240 fps
+        constexpr std::chrono::duration<double> simulationStep(1.0 / 120.0);
+
         bool running = true;
         SDL_Event event;
+
+        auto previousTime = clock::now();
+        std::chrono::duration<double> simulationAccumulator(0.0);
+        auto nextFrameDeadline = clock::now();
+
         while (running) {
             while (SDL_PollEvent(&event)) {
                 if (event.type == SDL_EVENT_QUIT) {
                     running = false;
                 }
+                if (event.type == SDL_EVENT_WINDOW_RESIZED) {
+                    //Per-window resize: only the window that changed rebuilds its swapchain
+                    for (WindowSurface& windowSurface : _windows)
+                        if (SDL_GetWindowID(windowSurface.window) == event.window.windowID)
+                            windowSurface.dirty = true;
+                }
+            }
+
+            const auto now = clock::now();
+            simulationAccumulator += now - previousTime;
+            previousTime = now;
+            while (simulationAccumulator >= simulationStep) {
+                update(simulationStep.count());
+                simulationAccumulator -= simulationStep;
+            }
+
+            _frameArena.reset(); //frame boundary: every scratch allocation below starts from zero
+
+            //Budgeted slice of pre-faulted asset data moves onto the transfer queue each frame
+            if (_packFile.isOpen())
+                _assetStreamer.pump(_uploadManager, _frameArena);
+
+            drawFrame();
+            _frameStats.recordFrame(_gpuProfiler.report());
+
+            /*Pace to the target frame rate instead of spinning the core at 100%:
+              coarse sleep to a couple of ms before the deadline (OS timers are only
+              millisecond-precise), then a short spin for the rest. On fanless
+              hardware the old busy-wait alone caused thermal throttling.*/
+            if (_config.targetFps > 0.0) {
+                const auto framePeriod = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / _config.targetFps));
+                nextFrameDeadline += framePeriod;
+
+                const auto afterDraw = clock::now();
+                if (nextFrameDeadline < afterDraw) {
+                    nextFrameDeadline = afterDraw; //fell behind - resynchronize instead of catching up in a burst
+                } else {
+                    constexpr auto sleepSlack = std::chrono::milliseconds(2);
+                    if (nextFrameDeadline - afterDraw > sleepSlack)
+                        std::this_thread::sleep_until(nextFrameDeadline - sleepSlack);
+                    while (clock::now() < nextFrameDeadline)
+                        std::this_thread::yield();
+                }
+            }
+        }
+        //Let in-flight frames drain before the RAII members start tearing down
+        _device.waitIdle();
+    }
+
+    //Fixed-timestep simulation tick; scene/game state updates go here
+    void update(double /*deltaSeconds*/) {
+    }
+
+    void createFrameEngine() {
+        _frameEngine.init(_device, _graphicsQueueIndex);
+        _commandRecorder.init(_device, _graphicsQueueIndex, &_jobSystem);
+        _gpuProfiler.init(_device, _physicalDevice, _graphicsQueueIndex, FrameEngine::MaxFramesInFlight);
+        _descriptorAllocator.init(_device, FrameEngine::MaxFramesInFlight);
+    }
+
+    void drawFrame() {
+        if (_headless) {
+            drawFrameHeadless();
+            return;
+        }
+
+        _jobSystem.beginFrame(); //frame-scoped job arena resets once last frame's jobs drained
+        FrameEngine::Frame& frame = _frameEngine.beginFrame(_device);
+        //Draw jobs feed CommandRecorder::recordAndExecute from recordCommandBuffer once there is geometry to record
+        _commandRecorder.beginFrame(_frameEngine.currentFrameSlot());
+        _streamingRing.beginFrame(_frameEngine.currentFrameSlot());
+        _descriptorAllocator.beginFrame(_frameEngine.currentFrameSlot());
+
+        const uint32_t frameSlot = _frameEngine.currentFrameSlot();
+
+        /*Acquire from every window up front. A window whose swapchain went out of
+          date sits this frame out and is recreated below - the other displays keep
+          presenting, so one output resizing never blanks the rest of the wall.*/
+        uint32_t acquiredCount = 0;
+        for (WindowSurface& windowSurface : _windows)
+        {
+            windowSurface.acquiredThisFrame = false;
+            if (windowSurface.dirty)
+                continue;
+            try {
+                auto [acquireResult, acquiredIndex] = windowSurface.swapChain.acquireNextImage(UINT64_MAX, windowSurface.acquireSemaphores[frameSlot]);
+                windowSurface.acquiredImage = acquiredIndex;
+                windowSurface.acquiredThisFrame = true;
+                acquiredCount++;
+                if (acquireResult == vk::Result::eSuboptimalKHR)
+                    windowSurface.dirty = true;
+            } catch (const vk::OutOfDateKHRError&) {
+                windowSurface.dirty = true;
             }
         }
+
+        if (acquiredCount == 0)
+        {
+            //Nothing was acquired, so nothing to submit - recreate and try again next frame
+            for (WindowSurface& windowSurface : _windows)
+                if (windowSurface.dirty)
+                    recreateSwapChain(windowSurface);
+            return;
+        }
+
+        _gpuProfiler.beginFrame(frameSlot, frame.commandBuffer);
+        //Complete the queue-ownership handoff for anything the streamer uploaded:
+        //the transfer queue released these ranges, this is the matching acquire
+        _uploadManager.recordGraphicsAcquire(frame.commandBuffer);
+        const uint32_t frameScope = _gpuProfiler.beginScope(frame.commandBuffer, "frame");
+        for (const WindowSurface& windowSurface : _windows)
+            if (windowSurface.acquiredThisFrame)
+                recordWindowClear(frame.commandBuffer, windowSurface, windowSurface.acquiredImage);
+        recordSceneWork(frame.commandBuffer);
+        _gpuProfiler.endScope(frame.commandBuffer, frameScope);
+
+        //One-shot work enqueued during the frame goes out as a single batched submit ahead of the frame itself
+        _submitManager.flush(_graphicsQueue);
+        //Compute batches go to their own queue and overlap the frame where the hardware allows
+        _asyncCompute.flush();
+
+        /*One submit waits on every acquire and signals every window's present
+          semaphore, then one batched present covers every acquired swapchain:
+          six outputs cost one vkQueuePresentKHR, not six serialized calls.*/
+        FrameVector<vk::Semaphore> acquireWaits{ FrameAllocator<vk::Semaphore>(_frameArena) };
+        FrameVector<vk::Semaphore> renderFinished{ FrameAllocator<vk::Semaphore>(_frameArena) };
+        FrameVector<vk::SwapchainKHR> swapChains{ FrameAllocator<vk::SwapchainKHR>(_frameArena) };
+        FrameVector<uint32_t> imageIndices{ FrameAllocator<uint32_t>(_frameArena) };
+        for (const WindowSurface& windowSurface : _windows)
+        {
+            if (!windowSurface.acquiredThisFrame)
+                continue;
+            acquireWaits.push_back(windowSurface.acquireSemaphores[frameSlot]);
+            renderFinished.push_back(windowSurface.renderFinishedSemaphores[windowSurface.acquiredImage]);
+            swapChains.push_back(windowSurface.swapChain);
+            imageIndices.push_back(windowSurface.acquiredImage);
+        }
+
+        //The submit also waits on the upload timeline so the acquire barriers above
+        //never execute before the transfer queue's release has actually finished
+        const vk::SemaphoreSubmitInfo uploadWait = _uploadManager.graphicsWaitInfo();
+        _frameEngine.submitFrame(_graphicsQueue, acquireWaits, renderFinished, { &uploadWait, 1 });
+
+        FrameVector<vk::Result> presentResults(swapChains.size(), FrameAllocator<vk::Result>(_frameArena));
+        const vk::PresentInfoKHR presentInfo{ .waitSemaphoreCount = static_cast<uint32_t>(renderFinished.size()),
+                                              .pWaitSemaphores = renderFinished.data(),
+                                              .swapchainCount = static_cast<uint32_t>(swapChains.size()),
+                                              .pSwapchains = swapChains.data(),
+                                              .pImageIndices = imageIndices.data(),
+                                              .pResults = presentResults.data() };
+        try {
+            _presentQueue.presentKHR(presentInfo);
+        } catch (const vk::OutOfDateKHRError&) {
+            //The per-swapchain results below say which window(s) actually went out of date
+        }
+
+        size_t resultIndex = 0;
+        for (WindowSurface& windowSurface : _windows)
+        {
+            if (!windowSurface.acquiredThisFrame)
+                continue;
+            const vk::Result presentResult = presentResults[resultIndex++];
+            if (presentResult == vk::Result::eSuboptimalKHR || presentResult == vk::Result::eErrorOutOfDateKHR)
+                windowSurface.dirty = true;
+        }
+
+        for (WindowSurface& windowSurface : _windows)
+            if (windowSurface.dirty)
+                recreateSwapChain(windowSurface);
+    }
+
+    /*Headless frame: same record path, but "present" is a copy into the target's
+      readback buffer. The copy is fenced by the frame engine's timeline - by the time
+      this target's frame slot cycles back, the readback contents are host-readable.*/
+    void drawFrameHeadless() {
+        _jobSystem.beginFrame();
+        FrameEngine::Frame& frame = _frameEngine.beginFrame(_device);
+        _commandRecorder.beginFrame(_frameEngine.currentFrameSlot());
+        _streamingRing.beginFrame(_frameEngine.currentFrameSlot());
+        _descriptorAllocator.beginFrame(_frameEngine.currentFrameSlot());
+
+        const uint32_t imageIndex = static_cast<uint32_t>(_frameEngine.frameNumber() % _offscreenTargets.size());
+
+        _gpuProfiler.beginFrame(_frameEngine.currentFrameSlot(), frame.commandBuffer);
+        _uploadManager.recordGraphicsAcquire(frame.commandBuffer);
+        const uint32_t frameScope = _gpuProfiler.beginScope(frame.commandBuffer, "frame");
+        recordWindowClear(frame.commandBuffer, _windows[0], imageIndex);
+        recordSceneWork(frame.commandBuffer);
+        recordReadbackCopy(frame.commandBuffer, imageIndex);
+        _gpuProfiler.endScope(frame.commandBuffer, frameScope);
+
+        _submitManager.flush(_graphicsQueue);
+        _asyncCompute.flush();
+        const vk::SemaphoreSubmitInfo uploadWait = _uploadManager.graphicsWaitInfo();
+        _frameEngine.submitFrame(_graphicsQueue, { &uploadWait, 1 });
+    }
+
+    void recordReadbackCopy(const vk::raii::CommandBuffer& commandBuffer, uint32_t imageIndex) {
+
+        //recordWindowClear() already left the image in eTransferSrcOptimal with the
+        //copy stage synchronized, so the readback is just the transfer itself
+        const OffscreenTarget& target = _offscreenTargets[imageIndex];
+
+        vk::BufferImageCopy region{
+            .imageSubresource = { .aspectMask = vk::ImageAspectFlagBits::eColor, .mipLevel = 0, .baseArrayLayer = 0, .layerCount = 1 },
+            .imageExtent = { .width = _windows[0].extent.width, .height = _windows[0].extent.height, .depth = 1 } };
+        commandBuffer.copyImageToBuffer(_windows[0].images[imageIndex], vk::ImageLayout::eTransferSrcOptimal,
+                                        target.readbackBuffer, region);
+    }
+
+    void recreateSwapChain(WindowSurface& windowSurface) {
+        windowSurface.dirty = false;
+
+        //A minimized window has a 0x0 drawable; retry once it has a real size again
+        int width = 0, height = 0;
+        SDL_GetWindowSizeInPixels(windowSurface.window, &width, &height);
+        if (width == 0 || height == 0) {
+            windowSurface.dirty = true;
+            return;
+        }
+
+        /*Wait only for our own in-flight graphics frames, not deviceWaitIdle:
+          transfer-queue streaming keeps running through the resize.*/
+        _frameEngine.waitForSubmitted(_device);
+
+        //createSwapChain() hands the retired swapchain to the driver as oldSwapchain so it can recycle image memory
+        createSwapChain(windowSurface);
+        createImageViews(windowSurface);
+        if (&windowSurface == &_windows.front())
+            _depthPyramid.create(windowSurface.extent); //depth and pyramid track the primary window's extent
+    }
+
+    /*Nothing is drawn yet, so clear the acquired image to give the frame engine real
+      GPU work to pipeline against CPU recording. The per-window rendering stages
+      slot in here; recorded once per window that acquired an image this frame.*/
+    void recordWindowClear(const vk::raii::CommandBuffer& commandBuffer, const WindowSurface& windowSurface, uint32_t imageIndex) {
+
+        vk::ImageMemoryBarrier2 toClearBarrier{
+            .srcStageMask = vk::PipelineStageFlagBits2::eTopOfPipe,
+            .dstStageMask = vk::PipelineStageFlagBits2::eClear,
+            .dstAccessMask = vk::AccessFlagBits2::eTransferWrite,
+            .oldLayout = vk::ImageLayout::eUndefined,
+            .newLayout = vk::ImageLayout::eTransferDstOptimal,
+            .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+            .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+            .image = windowSurface.images[imageIndex],
+            .subresourceRange = { .aspectMask = vk::ImageAspectFlagBits::eColor,
+                                  .baseMipLevel = 0,
+                                  .levelCount = 1,
+                                  .baseArrayLayer = 0,
+                                  .layerCount = 1 } };
+        commandBuffer.pipelineBarrier2(vk::DependencyInfo{ .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &toClearBarrier });
+
+        vk::ClearColorValue clearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        commandBuffer.clearColorImage(windowSurface.images[imageIndex], vk::ImageLayout::eTransferDstOptimal, clearColor,
+                                      vk::ImageSubresourceRange{ .aspectMask = vk::ImageAspectFlagBits::eColor,
+                                                                 .baseMipLevel = 0,
+                                                                 .levelCount = 1,
+                                                                 .baseArrayLayer = 0,
+                                                                 .layerCount = 1 });
+
+        //Headless targets are read back by a transfer instead of being presented
+        vk::ImageMemoryBarrier2 toPresentBarrier{
+            .srcStageMask = vk::PipelineStageFlagBits2::eClear,
+            .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+            .dstStageMask = _headless ? vk::PipelineStageFlagBits2::eCopy : vk::PipelineStageFlagBits2::eBottomOfPipe,
+            .dstAccessMask = _headless ? vk::AccessFlagBits2::eTransferRead : vk::AccessFlagBits2{},
+            .oldLayout = vk::ImageLayout::eTransferDstOptimal,
+            .newLayout = _headless ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR,
+            .srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+            .dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+            .image = windowSurface.images[imageIndex],
+            .subresourceRange = { .aspectMask = vk::ImageAspectFlagBits::eColor,
+                                  .baseMipLevel = 0,
+                                  .levelCount = 1,
+                                  .baseArrayLayer = 0,
+                                  .layerCount = 1 } };
+        commandBuffer.pipelineBarrier2(vk::DependencyInfo{ .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &toPresentBarrier });
+    }
+
+    //Window-independent GPU work - depth, occlusion and draw building happen once
+    //per frame no matter how many outputs consume the results
+    void recordSceneWork(const vk::raii::CommandBuffer& commandBuffer) {
+
+        /*Depth is cleared by transfer until the geometry prepass lands, but the HiZ
+          pyramid still rebuilds every frame so the culling path runs at real cost.
+          Once draws exist: prepass writes depth -> downsample -> recordCull gates
+          the indirect draws.*/
+        _depthPyramid.recordClear(commandBuffer);
+        _depthPyramid.recordDownsample(commandBuffer, _descriptorAllocator, vk::ImageLayout::eTransferDstOptimal);
+
+        /*GPU-driven path: cull against the fresh pyramid, then compact survivors into
+          indirect commands. _gpuScene.recordDraws() slots into the render pass once
+          the geometry pipelines land.*/
+        if (_gpuScene.objectCount() > 0) {
+            DepthPyramid::CullParams cullParams;
+            //Identity view-projection until a camera exists; occlusion still applies
+            for (int i = 0; i < 4; i++)
+                cullParams.viewProj[i * 4 + i] = 1.0f;
+            cullParams.objectCount = _gpuScene.objectCount();
+            _depthPyramid.recordCull(commandBuffer, _descriptorAllocator,
+                                     _gpuScene.boundsBuffer(), _gpuScene.visibilityBuffer(), cullParams);
+            _gpuScene.recordBuildDraws(commandBuffer, _descriptorAllocator);
+        }
     }
 
     void cleanup() {
-        SDL_Log("SDL3 shutdown");
-        SDL_DestroyWindow(_window);
+        _jobSystem.shutdown(); //drains in-flight jobs before anything they touch goes away
+        _assetStreamer.shutdown(); //the worker reads the pack mapping, so it stops before teardown
+        _shaderCache.shutdown(); //workers create modules against _device, so they stop first
+        _pipelineCacheStore.save();
 
-        SDL_Vulkan_UnloadLibrary();
+        SDL_Log("SDL3 shutdown");
+        for (WindowSurface& windowSurface : _windows)
+            if (windowSurface.window != nullptr)
+                SDL_DestroyWindow(windowSurface.window);
+        if (!_headless)
+            SDL_Vulkan_UnloadLibrary();
         SDL_Quit();
     }
 
     void pickPhysicalDevice() {
 
         auto devices = _instance.enumeratePhysicalDevices();
-        if (devices.empty()) 
+        if (devices.empty())
             throw std::runtime_error("failed to find GPUs with Vulkan support!");
 
-        const auto deviceIter = std::ranges::find_if(devices, [&]( const vk::raii::PhysicalDevice& device )
+        /*Fast path: the winner of a previous run, keyed on deviceUUID. Matching costs one
+          getProperties2 per device; the extension/feature sweep (the expensive part, ~80 ms
+          across a 3-GPU rig) only runs on the cached device, to confirm a driver update
+          did not take an extension away.*/
+        if (const std::string cachedUUID = loadCachedDeviceUUID(); !cachedUUID.empty())
+        {
+            for (const auto& device : devices)
+            {
+                if (deviceUUID(device) == cachedUUID && isDeviceSuitable(device))
+                {
+                    _physicalDevice = device;
+                    return;
+                }
+            }
+        }
+
+        /*Full pass: score every suitable device instead of taking the first match.
+          First-match routinely picked the iGPU over the discrete GPU on hybrid
+          laptops, a 5-10x rendering throughput difference.*/
+        uint64_t bestScore = 0;
+        const vk::raii::PhysicalDevice* bestDevice = nullptr;
+        for (const auto& device : devices)
         {
-            // Check if the device supports the Vulkan 1.4 API version
-            bool supportsVulkanAPI = device.getProperties().apiVersion >= VK_API_VERSION_1_4;
+            if (!isDeviceSuitable(device))
+                continue;
 
-            // Check if any of the queue families support graphics operations
-            auto queueFamilies = device.getQueueFamilyProperties();
-            bool supportsGraphics =
-            std::ranges::any_of( queueFamilies, []( const auto & qfp ) { return (qfp.queueFlags & vk::QueueFlagBits::eGraphics) != static_cast<vk::QueueFlags>(0); } );
+            const uint64_t score = scoreDevice(device);
+            if (bestDevice == nullptr || score > bestScore)
+            {
+                bestDevice = &device;
+                bestScore = score;
+            }
+        }
 
-            // Check if all required device extensions are available
-            auto availableDeviceExtensions = device.enumerateDeviceExtensionProperties();
-            bool supportsAllRequiredExtensions =
-            std::ranges::all_of( _requiredDeviceExtensions,
-                                   [&availableDeviceExtensions]( auto const & requiredDeviceExtension )
-                                   {
-                                     return std::ranges::any_of( availableDeviceExtensions,
-                                                                 [requiredDeviceExtension]( auto const & availableDeviceExtension )
-                                                                 { return strcmp( availableDeviceExtension.extensionName, requiredDeviceExtension ) == 0; } );
-                                   } );
+        if (bestDevice == nullptr)
+            throw std::runtime_error( "failed to find a suitable GPU!" );
 
+        _physicalDevice = *bestDevice;
+        saveCachedDeviceUUID(deviceUUID(_physicalDevice));
+    }
 
-            auto features = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan13Features, vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>();
-            bool supportsRequiredFeatures = features.get<vk::PhysicalDeviceVulkan13Features>().dynamicRendering &&
-                                            features.get<vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>().extendedDynamicState;
+    bool isDeviceSuitable(const vk::raii::PhysicalDevice& device) const {
 
-            return supportsVulkanAPI && supportsGraphics && supportsAllRequiredExtensions && supportsRequiredFeatures;
-        } );
+        // Check if the device supports the Vulkan 1.4 API version
+        bool supportsVulkanAPI = device.getProperties().apiVersion >= VK_API_VERSION_1_4;
 
-        if ( deviceIter != devices.end() )
+        // Check if any of the queue families support graphics operations
+        auto queueFamilies = device.getQueueFamilyProperties();
+        bool supportsGraphics =
+        std::ranges::any_of( queueFamilies, []( const auto & qfp ) { return (qfp.queueFlags & vk::QueueFlagBits::eGraphics) != static_cast<vk::QueueFlags>(0); } );
+
+        // Check if all required device extensions are available
+        auto availableDeviceExtensions = device.enumerateDeviceExtensionProperties();
+        bool supportsAllRequiredExtensions =
+        std::ranges::all_of( _requiredDeviceExtensions,
+                               [&availableDeviceExtensions]( auto const & requiredDeviceExtension )
+                               {
+                                 return std::ranges::any_of( availableDeviceExtensions,
+                                                             [requiredDeviceExtension]( auto const & availableDeviceExtension )
+                                                             { return strcmp( availableDeviceExtension.extensionName, requiredDeviceExtension ) == 0; } );
+                               } );
+
+
+        auto features = device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan13Features, vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>();
+        bool supportsRequiredFeatures = features.get<vk::PhysicalDeviceVulkan13Features>().dynamicRendering &&
+                                        features.get<vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>().extendedDynamicState;
+
+        return supportsVulkanAPI && supportsGraphics && supportsAllRequiredExtensions && supportsRequiredFeatures;
+    }
+
+    /*Ranks suitable devices: device type dominates (discrete beats integrated no matter
+      the VRAM), then the largest device-local heap in MB, then queue-family richness -
+      dedicated transfer and compute families enable the async-queue subsystems.*/
+    static uint64_t scoreDevice(const vk::raii::PhysicalDevice& device) {
+
+        uint64_t score = 0;
+        switch (device.getProperties().deviceType)
         {
-            _physicalDevice = *deviceIter;
+            case vk::PhysicalDeviceType::eDiscreteGpu:   score += 10'000'000; break;
+            case vk::PhysicalDeviceType::eIntegratedGpu: score += 1'000'000;  break;
+            case vk::PhysicalDeviceType::eVirtualGpu:    score += 100'000;    break;
+            default:                                     score += 10'000;     break;
         }
-        else
+
+        const auto memoryProperties = device.getMemoryProperties();
+        vk::DeviceSize largestDeviceLocalHeap = 0;
+        for (uint32_t heap = 0; heap < memoryProperties.memoryHeapCount; heap++)
         {
-            throw std::runtime_error( "failed to find a suitable GPU!" );
+            if (memoryProperties.memoryHeaps[heap].flags & vk::MemoryHeapFlagBits::eDeviceLocal)
+                largestDeviceLocalHeap = std::max(largestDeviceLocalHeap, memoryProperties.memoryHeaps[heap].size);
+        }
+        score += largestDeviceLocalHeap >> 20; //MB
+
+        for (const auto& qfp : device.getQueueFamilyProperties())
+        {
+            const bool hasGraphics = (qfp.queueFlags & vk::QueueFlagBits::eGraphics) != static_cast<vk::QueueFlags>(0);
+            const bool hasCompute = (qfp.queueFlags & vk::QueueFlagBits::eCompute) != static_cast<vk::QueueFlags>(0);
+            const bool hasTransfer = (qfp.queueFlags & vk::QueueFlagBits::eTransfer) != static_cast<vk::QueueFlags>(0);
+            if (hasTransfer && !hasGraphics && !hasCompute)
+                score += 500; //DMA engine
+            if (hasCompute && !hasGraphics)
+                score += 500; //async compute
         }
+        return score;
+    }
+
+    static std::string deviceUUID(const vk::raii::PhysicalDevice& device) {
+
+        const auto idProperties =
+            device.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceIDProperties>().get<vk::PhysicalDeviceIDProperties>();
+
+        std::string hex;
+        for (const uint8_t byte : idProperties.deviceUUID)
+            hex += std::format("{:02x}", byte);
+        return hex;
+    }
+
+    static std::string loadCachedDeviceUUID() {
+
+        std::ifstream file("device_cache.json");
+        if (!file)
+            return {};
+        try
+        {
+            return nlohmann::json::parse(file).value("deviceUUID", std::string{});
+        }
+        catch (const nlohmann::json::exception&)
+        {
+            return {}; //stale or corrupt cache just means one slow startup
+        }
+    }
+
+    static void saveCachedDeviceUUID(const std::string& uuid) {
+        std::ofstream file("device_cache.json", std::ios::trunc);
+        if (file)
+            file << nlohmann::json{ {"deviceUUID", uuid} }.dump(2);
     }
 
     void createLogicalDevice() {
@@ -229,7 +860,10 @@ private:
         for (uint32_t qfpIndex = 0; qfpIndex < queueFamilyProperties.size(); qfpIndex++)
         {
             const bool supportsGraphics = (queueFamilyProperties[qfpIndex].queueFlags & vk::QueueFlagBits::eGraphics) != static_cast<vk::QueueFlags>(0);
-            const bool supportsSurface = _physicalDevice.getSurfaceSupportKHR(qfpIndex, *_surface);
+            //Every window must be presentable from the same family - one present path for the whole wall
+            bool supportsSurface = !_headless;
+            for (const WindowSurface& windowSurface : _windows)
+                supportsSurface = supportsSurface && _physicalDevice.getSurfaceSupportKHR(qfpIndex, *windowSurface.surface);
 
             if (supportsGraphics)
                 graphicsQueueIndex = static_cast<uint32_t>(qfpIndex);
@@ -242,44 +876,113 @@ private:
 
         }
 
+        //Nothing is presented in headless mode; reusing the graphics index keeps the
+        //rest of the queue plumbing identical
+        if (_headless)
+            presentQueueIndex = graphicsQueueIndex;
+
         if ( (graphicsQueueIndex == UINT32_MAX) || (presentQueueIndex == UINT32_MAX) )
         {
             throw std::runtime_error( "Could not find a queue for graphics or present -> terminating" );
         }
 
-        //This is exclusive for this tutorial but we NEED the queues to be the same
-        //This is because swap chain VK_SHARING_MODE
-        //TODO: Add support for VK_SHARING_MODE_CONCURRENT
-        if ( graphicsQueueIndex != presentQueueIndex)
+        /*Look for a transfer-only family (no graphics/compute bits): that is the DMA engine,
+          and copies submitted there overlap rendering instead of stalling it. Graphics
+          families always support transfer, so the graphics family is the fallback.*/
+        uint32_t transferQueueIndex = graphicsQueueIndex;
+        for (uint32_t qfpIndex = 0; qfpIndex < queueFamilyProperties.size(); qfpIndex++)
         {
-            throw std::runtime_error( "Could not find a queue for both graphics and present." );
+            const auto flags = queueFamilyProperties[qfpIndex].queueFlags;
+            const bool transferOnly = (flags & vk::QueueFlagBits::eTransfer) != static_cast<vk::QueueFlags>(0) &&
+                                      (flags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute)) == static_cast<vk::QueueFlags>(0);
+            if (transferOnly)
+            {
+                transferQueueIndex = qfpIndex;
+                break;
+            }
         }
-        
-        // query for Vulkan 1.3 features
-        vk::StructureChain<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan13Features, vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT> featureChain = {
-            {},                               // vk::PhysicalDeviceFeatures2
+
+        /*Same idea for compute: a compute-capable family without graphics is the async
+          compute engine, and batches submitted there fill the graphics queue's bubbles.
+          Falling back to the graphics family keeps the API identical, just serialized.*/
+        uint32_t computeQueueIndex = graphicsQueueIndex;
+        for (uint32_t qfpIndex = 0; qfpIndex < queueFamilyProperties.size(); qfpIndex++)
+        {
+            const auto flags = queueFamilyProperties[qfpIndex].queueFlags;
+            const bool computeNoGraphics = (flags & vk::QueueFlagBits::eCompute) != static_cast<vk::QueueFlags>(0) &&
+                                           (flags & vk::QueueFlagBits::eGraphics) == static_cast<vk::QueueFlags>(0);
+            if (computeNoGraphics)
+            {
+                computeQueueIndex = qfpIndex;
+                break;
+            }
+        }
+
+        /*The families can legitimately differ (older AMD cards, hybrid laptop GPUs).
+          The search above already prefers a family that supports both, because matching
+          families let the swapchain use exclusive sharing, which is faster. When they
+          differ we fall back to VK_SHARING_MODE_CONCURRENT in createSwapChain().*/
+
+        /*Descriptor indexing is detected rather than required: a fleet chunk (older
+          mobile parts, some virtual GPUs) lacks update-after-bind, and those units
+          fall back to the classic per-draw descriptor sets. Everything the bindless
+          table needs is core in Vulkan 1.2, so one feature struct covers it.*/
+        const auto supportedFeatures = _physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        const auto& supported12 = supportedFeatures.get<vk::PhysicalDeviceVulkan12Features>();
+        _drawIndirectCountSupported = static_cast<bool>(supported12.drawIndirectCount);
+        _descriptorIndexingSupported = supported12.runtimeDescriptorArray &&
+                                       supported12.shaderSampledImageArrayNonUniformIndexing &&
+                                       supported12.descriptorBindingPartiallyBound &&
+                                       supported12.descriptorBindingSampledImageUpdateAfterBind &&
+                                       supported12.descriptorBindingVariableDescriptorCount;
+        //drawCount > 1 on vkCmdDrawIndexedIndirect needs this; GpuScene's zero-filled
+        //fallback loops per slot when it is missing
+        _multiDrawIndirectSupported =
+            static_cast<bool>(supportedFeatures.get<vk::PhysicalDeviceFeatures2>().features.multiDrawIndirect);
+
+        // query for Vulkan 1.2/1.3 features
+        vk::StructureChain<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features, vk::PhysicalDeviceVulkan13Features, vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT> featureChain = {
+            {.features = {.multiDrawIndirect = _multiDrawIndirectSupported } }, // vk::PhysicalDeviceFeatures2
+            {.drawIndirectCount = _drawIndirectCountSupported,
+             .shaderSampledImageArrayNonUniformIndexing = _descriptorIndexingSupported,
+             .descriptorBindingSampledImageUpdateAfterBind = _descriptorIndexingSupported,
+             .descriptorBindingPartiallyBound = _descriptorIndexingSupported,
+             .descriptorBindingVariableDescriptorCount = _descriptorIndexingSupported,
+             .runtimeDescriptorArray = _descriptorIndexingSupported }, // vk::PhysicalDeviceVulkan12Features
             {.dynamicRendering = true },      // vk::PhysicalDeviceVulkan13Features
             {.extendedDynamicState = true }   // vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT
         };
 
-        // create a Device
+        // create a Device with one queue per distinct family
         float queuePriority = 0.0f;
-        vk::DeviceQueueCreateInfo deviceQueueCreateInfo{ .queueFamilyIndex = graphicsQueueIndex, .queueCount = 1, .pQueuePriorities = &queuePriority };
+        std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
+        queueCreateInfos.push_back(vk::DeviceQueueCreateInfo{ .queueFamilyIndex = graphicsQueueIndex, .queueCount = 1, .pQueuePriorities = &queuePriority });
+        if (presentQueueIndex != graphicsQueueIndex)
+            queueCreateInfos.push_back(vk::DeviceQueueCreateInfo{ .queueFamilyIndex = presentQueueIndex, .queueCount = 1, .pQueuePriorities = &queuePriority });
+        if (transferQueueIndex != graphicsQueueIndex && transferQueueIndex != presentQueueIndex)
+            queueCreateInfos.push_back(vk::DeviceQueueCreateInfo{ .queueFamilyIndex = transferQueueIndex, .queueCount = 1, .pQueuePriorities = &queuePriority });
+        if (computeQueueIndex != graphicsQueueIndex && computeQueueIndex != presentQueueIndex && computeQueueIndex != transferQueueIndex)
+            queueCreateInfos.push_back(vk::DeviceQueueCreateInfo{ .queueFamilyIndex = computeQueueIndex, .queueCount = 1, .pQueuePriorities = &queuePriority });
+
         vk::DeviceCreateInfo deviceCreateInfo{ .pNext = &featureChain.get<vk::PhysicalDeviceFeatures2>(),
-                                                .queueCreateInfoCount = 1,
-                                                .pQueueCreateInfos = &deviceQueueCreateInfo,
+                                                .queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size()),
+                                                .pQueueCreateInfos = queueCreateInfos.data(),
                                                 .enabledExtensionCount = static_cast<uint32_t>(_requiredDeviceExtensions.size()),
                                                 .ppEnabledExtensionNames = _requiredDeviceExtensions.data() };
 
         _device = vk::raii::Device(_physicalDevice, deviceCreateInfo);
+        _graphicsQueueIndex = graphicsQueueIndex;
+        _presentQueueIndex = presentQueueIndex;
+        _transferQueueIndex = transferQueueIndex;
+        _computeQueueIndex = computeQueueIndex;
         _graphicsQueue = vk::raii::Queue( _device, graphicsQueueIndex, 0);
         _presentQueue = vk::raii::Queue( _device, presentQueueIndex, 0);
     }
 
-    void createSwapChain() {
-        auto surfaceCapabilities = _physicalDevice.getSurfaceCapabilitiesKHR( _surface );
-        _swapChainImageFormat = chooseSwapSurfaceFormat(_physicalDevice.getSurfaceFormatsKHR( _surface ));
-        _swapChainExtent = chooseSwapExtent(surfaceCapabilities);
+    void createSwapChain(WindowSurface& windowSurface) {
+        auto surfaceCapabilities = _physicalDevice.getSurfaceCapabilitiesKHR( windowSurface.surface );
+        windowSurface.imageFormat = chooseSwapSurfaceFormat(_physicalDevice.getSurfaceFormatsKHR( windowSurface.surface ));
+        windowSurface.extent = chooseSwapExtent(windowSurface.window, surfaceCapabilities);
 
         /*
         simply sticking to this minimum means that we may sometimes have to wait on the driver to complete 
@@ -294,25 +997,89 @@ private:
         where 0 is a special value that means that there is no maximum
         */
         minImageCount = ( surfaceCapabilities.maxImageCount > 0 && minImageCount > surfaceCapabilities.maxImageCount ) ? surfaceCapabilities.maxImageCount : minImageCount;
-        
-        
+
+        const bool sameQueueFamily = (_graphicsQueueIndex == _presentQueueIndex);
+        std::array<uint32_t, 2> sharingQueueFamilies = { _graphicsQueueIndex, _presentQueueIndex };
+
+
         vk::SwapchainCreateInfoKHR swapChainCreateInfo{
-            .surface = _surface, 
+            .surface = windowSurface.surface,
             .minImageCount = minImageCount,
-            .imageFormat = _swapChainImageFormat, 
+            .imageFormat = windowSurface.imageFormat,
             .imageColorSpace = vk::ColorSpaceKHR::eSrgbNonlinear,
-            .imageExtent = _swapChainExtent, 
+            .imageExtent = windowSurface.extent,
             .imageArrayLayers =1,
             .imageUsage = vk::ImageUsageFlagBits::eColorAttachment,
-             //TODO: Add support for VK_SHARING_MODE_CONCURRENT 
-            .imageSharingMode = vk::SharingMode::eExclusive,
-            .preTransform = surfaceCapabilities.currentTransform, 
+            /*Exclusive when one family does both graphics and present - measurably faster.
+              Concurrent sharing between the two families otherwise, so we never need
+              per-frame queue ownership transfers on the swapchain images.*/
+            .imageSharingMode = sameQueueFamily ? vk::SharingMode::eExclusive : vk::SharingMode::eConcurrent,
+            .queueFamilyIndexCount = sameQueueFamily ? 0u : static_cast<uint32_t>(sharingQueueFamilies.size()),
+            .pQueueFamilyIndices = sameQueueFamily ? nullptr : sharingQueueFamilies.data(),
+            .preTransform = surfaceCapabilities.currentTransform,
             .compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eOpaque,
-            .presentMode = chooseSwapPresentMode(_physicalDevice.getSurfacePresentModesKHR(_surface)),
-            .clipped = true };
+            .presentMode = chooseSwapPresentMode(_physicalDevice.getSurfacePresentModesKHR(windowSurface.surface)),
+            .clipped = true,
+            .oldSwapchain = windowSurface.swapChain };
+
+        //Construct before assigning: the retired swapchain must stay alive while the driver
+        //recycles its images into the new one, and may only be destroyed afterwards.
+        vk::raii::SwapchainKHR newSwapChain( _device, swapChainCreateInfo );
+        windowSurface.swapChain = std::move(newSwapChain);
+        windowSurface.images = windowSurface.swapChain.getImages();
+
+        //renderFinished semaphores are per swapchain image and the image count may have changed
+        windowSurface.renderFinishedSemaphores.clear();
+        for (size_t i = 0; i < windowSurface.images.size(); i++)
+            windowSurface.renderFinishedSemaphores.emplace_back(_device, vk::SemaphoreCreateInfo{});
+
+        //Acquire semaphores are per frame slot and survive swapchain recreation
+        if (windowSurface.acquireSemaphores.empty())
+            for (uint32_t i = 0; i < FrameEngine::MaxFramesInFlight; i++)
+                windowSurface.acquireSemaphores.emplace_back(_device, vk::SemaphoreCreateInfo{});
+    }
 
-        _swapChain = vk::raii::SwapchainKHR( _device, swapChainCreateInfo );
-        _swapChainImages = _swapChain.getImages();
+    /*Headless replacement for createSwapChain(): plain color images with a host-visible
+      readback buffer each. Three targets like the swapchain minimum, so the "present"
+      copy of frame N never blocks the clear of frame N+1.*/
+    void createOffscreenTargets() {
+        //Headless routes the record path through one pseudo-surface: no window,
+        //surface or swapchain behind it, just the images
+        _windows.resize(1);
+        WindowSurface& windowSurface = _windows[0];
+        windowSurface.imageFormat = vk::Format::eB8G8R8A8Srgb;
+        windowSurface.extent = vk::Extent2D{ static_cast<uint32_t>(_config.windowWidth), static_cast<uint32_t>(_config.windowHeight) };
+
+        _offscreenTargets.clear();
+        windowSurface.images.clear();
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            OffscreenTarget target;
+            target.image = vk::raii::Image(_device, vk::ImageCreateInfo{
+                .imageType = vk::ImageType::e2D,
+                .format = windowSurface.imageFormat,
+                .extent = { .width = windowSurface.extent.width, .height = windowSurface.extent.height, .depth = 1 },
+                .mipLevels = 1,
+                .arrayLayers = 1,
+                .samples = vk::SampleCountFlagBits::e1,
+                .tiling = vk::ImageTiling::eOptimal,
+                .usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc,
+                .sharingMode = vk::SharingMode::eExclusive,
+                .initialLayout = vk::ImageLayout::eUndefined });
+            target.imageAllocation = _gpuAllocator.allocate(target.image.getMemoryRequirements(), vk::MemoryPropertyFlagBits::eDeviceLocal);
+            target.image.bindMemory(target.imageAllocation.memory, target.imageAllocation.offset);
+
+            const vk::DeviceSize readbackSize = vk::DeviceSize(windowSurface.extent.width) * windowSurface.extent.height * 4;
+            target.readbackBuffer = vk::raii::Buffer(_device, vk::BufferCreateInfo{ .size = readbackSize,
+                                                                                    .usage = vk::BufferUsageFlagBits::eTransferDst,
+                                                                                    .sharingMode = vk::SharingMode::eExclusive });
+            target.readbackAllocation = _gpuAllocator.allocate(target.readbackBuffer.getMemoryRequirements(),
+                                                               vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+            target.readbackBuffer.bindMemory(target.readbackAllocation.memory, target.readbackAllocation.offset);
+
+            windowSurface.images.push_back(target.image); //createImageViews() and the record path work unchanged
+            _offscreenTargets.push_back(std::move(target));
+        }
     }
 
     static vk::Format chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats) {
@@ -331,9 +1098,29 @@ private:
     //               before vsync (triple-buffered). Low latency, no tearing.
     // IMMEDIATE   = Presents immediately without waiting for vsync (fastest, can tear).
     // RELAXED_FIFO= Like FIFO but presents immediately if frame is late (can tear).
-    static vk::PresentModeKHR chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes) {
-        return std::ranges::any_of(availablePresentModes,
-            [](const vk::PresentModeKHR value) { return vk::PresentModeKHR::eMailbox == value; } ) ? vk::PresentModeKHR::eMailbox : vk::PresentModeKHR::eFifo;
+    //
+    // Which one is right depends on the deployment (esports wants IMMEDIATE, signage
+    // wants FIFO for power), so the config's presentModePolicy maps to a preference
+    // list and we take the first mode the surface actually supports. FIFO is the
+    // only mode the spec guarantees, so every list ends there.
+    vk::PresentModeKHR chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes) const {
+
+        std::vector<vk::PresentModeKHR> preferred;
+        if (_config.presentModePolicy == "lowLatency")
+            preferred = { vk::PresentModeKHR::eImmediate, vk::PresentModeKHR::eFifoRelaxed };
+        else if (_config.presentModePolicy == "powerSave")
+            preferred = {};
+        else if (_config.presentModePolicy == "adaptive")
+            preferred = { vk::PresentModeKHR::eFifoRelaxed };
+        else //"smooth" and anything unrecognized
+            preferred = { vk::PresentModeKHR::eMailbox };
+
+        for (const vk::PresentModeKHR mode : preferred)
+        {
+            if (std::ranges::contains(availablePresentModes, mode))
+                return mode;
+        }
+        return vk::PresentModeKHR::eFifo;
     }
 
     // swapExtent defines the resolution of images in the swapchain.
@@ -341,12 +1128,12 @@ private:
     // the image to fit the surface. Smaller extents = fewer pixels 
     // to render (faster, lower quality). Larger extents = more detail 
     // but heavier GPU load. Aspect ratio mismatches may cause stretching.
-    vk::Extent2D chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities) {
+    vk::Extent2D chooseSwapExtent(SDL_Window* window, const vk::SurfaceCapabilitiesKHR& capabilities) {
         if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max()) {
             return capabilities.currentExtent;
         }
         int width, height;
-        SDL_GetWindowSizeInPixels(_window, &width, &height);
+        SDL_GetWindowSizeInPixels(window, &width, &height);
 
         return {
             std::clamp<uint32_t>(width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width),
@@ -354,31 +1141,45 @@ private:
         };
     }
 
-     void createImageViews() {
-        _swapChainImageViews.clear();
+     void createImageViews(WindowSurface& windowSurface) {
+        windowSurface.imageViews.clear();
 
         vk::ImageViewCreateInfo imageViewCreateInfo
-        { 
-            .viewType = vk::ImageViewType::e2D, 
-            .format = _swapChainImageFormat,
-            .subresourceRange = { .aspectMask = vk::ImageAspectFlagBits::eColor, 
-                                .baseMipLevel = 0, 
-                                .levelCount = 1, 
-                                .baseArrayLayer = 0, 
-                                .layerCount = 1 
-                            } 
+        {
+            .viewType = vk::ImageViewType::e2D,
+            .format = windowSurface.imageFormat,
+            .subresourceRange = { .aspectMask = vk::ImageAspectFlagBits::eColor,
+                                .baseMipLevel = 0,
+                                .levelCount = 1,
+                                .baseArrayLayer = 0,
+                                .layerCount = 1
+                            }
         };
-        for ( auto image : _swapChainImages )
+        for ( auto image : windowSurface.images )
         {
             imageViewCreateInfo.image = image;
-            _swapChainImageViews.emplace_back( _device, imageViewCreateInfo );
+            windowSurface.imageViews.emplace_back( _device, imageViewCreateInfo );
         }
     }
 
+    std::string resolveValidationMode() const {
+        if (const char* env = std::getenv("VULKAN_TUTORIAL_VALIDATION"))
+            return env;
+        if (!_config.validationMode.empty())
+            return _config.validationMode;
+        return enableValidationLayers ? "full" : "errors";
+    }
+
     void setupDebugMessenger() {
-        if (!enableValidationLayers) return;
+        if (_validationMode == "off") return;
+
+        /*"errors" keeps just the messenger at Error severity - the expensive part is the
+          validation layer itself, not the messenger, so deployed units can report driver
+          errors without the validation tax (and without spamming stderr).*/
+        vk::DebugUtilsMessageSeverityFlagsEXT severityFlags( vk::DebugUtilsMessageSeverityFlagBitsEXT::eError );
+        if (_validationMode == "full")
+            severityFlags |= vk::DebugUtilsMessageSeverityFlagBitsEXT::eVerbose | vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning;
 
-        vk::DebugUtilsMessageSeverityFlagsEXT severityFlags( vk::DebugUtilsMessageSeverityFlagBitsEXT::eVerbose | vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning | vk::DebugUtilsMessageSeverityFlagBitsEXT::eError );
         vk::DebugUtilsMessageTypeFlagsEXT messageTypeFlags( vk::DebugUtilsMessageTypeFlagBitsEXT::eGeneral | vk::DebugUtilsMessageTypeFlagBitsEXT::ePerformance | vk::DebugUtilsMessageTypeFlagBitsEXT::eValidation );
         vk::DebugUtilsMessengerCreateInfoEXT debugUtilsMessengerCreateInfoEXT{
             .messageSeverity = severityFlags,
@@ -390,11 +1191,14 @@ private:
 
     const std::vector<const char*> getRequiredExtensions()
     {
-        uint32_t countInstanceExtensions;
-        const char * const *instanceExtensions = SDL_Vulkan_GetInstanceExtensions(&countInstanceExtensions);
-
-        std::vector<const char*> extensions(instanceExtensions, instanceExtensions + countInstanceExtensions);
-        if (enableValidationLayers) {
+        std::vector<const char*> extensions;
+        if (!_headless) {
+            //Surface extensions only make sense with a window to present to
+            uint32_t countInstanceExtensions;
+            const char * const *instanceExtensions = SDL_Vulkan_GetInstanceExtensions(&countInstanceExtensions);
+            extensions.assign(instanceExtensions, instanceExtensions + countInstanceExtensions);
+        }
+        if (_validationMode != "off") {
             extensions.push_back(vk::EXTDebugUtilsExtensionName );
         }
 
@@ -407,9 +1211,10 @@ private:
             "VK_LAYER_KHRONOS_validation"
         };
 
-        // Get the required layers
+        // Only "full" loads the layer - it alone costs 30-40% in debug-heavy frames,
+        // while the messenger that "errors" keeps is essentially free
         std::vector<char const*> requiredLayers;
-        if (enableValidationLayers) {
+        if (_validationMode == "full") {
             requiredLayers.assign(validationLayers.begin(), validationLayers.end());
         }
         return requiredLayers;